@@ -0,0 +1,422 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+/*
+ * Measures the cost of the labpack wrapper by running identical workloads
+ * through the raw mpack API and through labpack, and prints the time per
+ * call of each and the difference as JSON.
+ *
+ * Usage: labpack_overhead [seconds]
+ *
+ * Each workload is repeated for at least the given number of seconds of
+ * processor time, which is 0.5 by default. The mpack used for the raw
+ * workloads is compiled into this executable with the same configuration as
+ * the library.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mpack.h"
+
+#include "labpack.h"
+
+// The number of values in each message, which is large enough that the
+// begin and end of the message do not dominate the time per call.
+#define VALUES_COUNT 4096
+#define BUFFER_SIZE (VALUES_COUNT * 16)
+
+typedef struct {
+    const char* name;
+    // The number of API calls made by one run, not counting begin and end
+    uint32_t calls;
+    void (*raw)(void);
+    void (*wrapped)(void);
+} workload_t;
+
+static const char* STATE = "Running";
+static const char* KEY = "code";
+
+// Keeps the decoded values alive, so the decoding is not optimized away.
+static volatile double sink = 0.0;
+
+static char raw_buffer[BUFFER_SIZE];
+static labpack_writer_t* writer = NULL;
+static labpack_reader_t* reader = NULL;
+
+static char* u8_data = NULL;
+static size_t u8_size = 0;
+static char* double_data = NULL;
+static size_t double_size = 0;
+static char* str_data = NULL;
+static size_t str_size = 0;
+static char* map_data = NULL;
+static size_t map_size = 0;
+
+static void
+raw_write_u8()
+{
+    mpack_writer_t encoder;
+    mpack_writer_init(&encoder, raw_buffer, sizeof(raw_buffer));
+    mpack_start_array(&encoder, VALUES_COUNT);
+    for (uint32_t i = 0; i < VALUES_COUNT; i++) {
+        mpack_write_u8(&encoder, (uint8_t)(i & 0x7f));
+    }
+    mpack_finish_array(&encoder);
+    sink += (double)mpack_writer_buffer_used(&encoder);
+    mpack_writer_destroy(&encoder);
+}
+
+static void
+labpack_write_u8s()
+{
+    labpack_writer_begin(writer);
+    labpack_writer_begin_array(writer, VALUES_COUNT);
+    for (uint32_t i = 0; i < VALUES_COUNT; i++) {
+        labpack_write_u8(writer, (uint8_t)(i & 0x7f));
+    }
+    labpack_writer_end_array(writer);
+    labpack_writer_end(writer);
+    sink += (double)labpack_writer_buffer_size(writer);
+}
+
+static void
+raw_write_double()
+{
+    mpack_writer_t encoder;
+    mpack_writer_init(&encoder, raw_buffer, sizeof(raw_buffer));
+    mpack_start_array(&encoder, VALUES_COUNT);
+    for (uint32_t i = 0; i < VALUES_COUNT; i++) {
+        mpack_write_double(&encoder, i * 0.5);
+    }
+    mpack_finish_array(&encoder);
+    sink += (double)mpack_writer_buffer_used(&encoder);
+    mpack_writer_destroy(&encoder);
+}
+
+static void
+labpack_write_doubles()
+{
+    labpack_writer_begin(writer);
+    labpack_writer_begin_array(writer, VALUES_COUNT);
+    for (uint32_t i = 0; i < VALUES_COUNT; i++) {
+        labpack_write_double(writer, i * 0.5);
+    }
+    labpack_writer_end_array(writer);
+    labpack_writer_end(writer);
+    sink += (double)labpack_writer_buffer_size(writer);
+}
+
+static void
+raw_write_str()
+{
+    mpack_writer_t encoder;
+    mpack_writer_init(&encoder, raw_buffer, sizeof(raw_buffer));
+    mpack_start_array(&encoder, VALUES_COUNT);
+    for (uint32_t i = 0; i < VALUES_COUNT; i++) {
+        mpack_write_str(&encoder, STATE, 7);
+    }
+    mpack_finish_array(&encoder);
+    sink += (double)mpack_writer_buffer_used(&encoder);
+    mpack_writer_destroy(&encoder);
+}
+
+static void
+labpack_write_strs()
+{
+    labpack_writer_begin(writer);
+    labpack_writer_begin_array(writer, VALUES_COUNT);
+    for (uint32_t i = 0; i < VALUES_COUNT; i++) {
+        labpack_write_str(writer, STATE, 7);
+    }
+    labpack_writer_end_array(writer);
+    labpack_writer_end(writer);
+    sink += (double)labpack_writer_buffer_size(writer);
+}
+
+static void
+raw_write_map()
+{
+    mpack_writer_t encoder;
+    mpack_writer_init(&encoder, raw_buffer, sizeof(raw_buffer));
+    mpack_start_array(&encoder, VALUES_COUNT / 4);
+    for (uint32_t i = 0; i < VALUES_COUNT / 4; i++) {
+        mpack_start_map(&encoder, 1);
+        mpack_write_str(&encoder, KEY, 4);
+        mpack_write_u32(&encoder, i);
+        mpack_finish_map(&encoder);
+    }
+    mpack_finish_array(&encoder);
+    sink += (double)mpack_writer_buffer_used(&encoder);
+    mpack_writer_destroy(&encoder);
+}
+
+static void
+labpack_write_maps()
+{
+    labpack_writer_begin(writer);
+    labpack_writer_begin_array(writer, VALUES_COUNT / 4);
+    for (uint32_t i = 0; i < VALUES_COUNT / 4; i++) {
+        labpack_writer_begin_map(writer, 1);
+        labpack_write_str(writer, KEY, 4);
+        labpack_write_u32(writer, i);
+        labpack_writer_end_map(writer);
+    }
+    labpack_writer_end_array(writer);
+    labpack_writer_end(writer);
+    sink += (double)labpack_writer_buffer_size(writer);
+}
+
+static void
+raw_read_u8()
+{
+    mpack_reader_t decoder;
+    mpack_reader_init_data(&decoder, u8_data, u8_size);
+    uint32_t count = mpack_expect_array(&decoder);
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += mpack_expect_u8(&decoder);
+    }
+    mpack_done_array(&decoder);
+    mpack_reader_destroy(&decoder);
+    sink += sum;
+}
+
+static void
+labpack_read_u8s()
+{
+    labpack_reader_begin(reader, u8_data, u8_size);
+    uint32_t count = labpack_reader_begin_array(reader);
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += labpack_read_u8(reader);
+    }
+    labpack_reader_end_array(reader);
+    labpack_reader_end(reader);
+    sink += sum;
+}
+
+static void
+raw_read_double()
+{
+    mpack_reader_t decoder;
+    mpack_reader_init_data(&decoder, double_data, double_size);
+    uint32_t count = mpack_expect_array(&decoder);
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += mpack_expect_double(&decoder);
+    }
+    mpack_done_array(&decoder);
+    mpack_reader_destroy(&decoder);
+    sink += sum;
+}
+
+static void
+labpack_read_doubles()
+{
+    labpack_reader_begin(reader, double_data, double_size);
+    uint32_t count = labpack_reader_begin_array(reader);
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += labpack_read_double(reader);
+    }
+    labpack_reader_end_array(reader);
+    labpack_reader_end(reader);
+    sink += sum;
+}
+
+static void
+raw_read_str()
+{
+    char buffer[16];
+    mpack_reader_t decoder;
+    mpack_reader_init_data(&decoder, str_data, str_size);
+    uint32_t count = mpack_expect_array(&decoder);
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t length = mpack_expect_str_max(&decoder, sizeof(buffer));
+        mpack_read_bytes(&decoder, buffer, length);
+        mpack_done_str(&decoder);
+        total += length;
+    }
+    mpack_done_array(&decoder);
+    mpack_reader_destroy(&decoder);
+    sink += total;
+}
+
+static void
+labpack_read_strs()
+{
+    char buffer[16];
+    labpack_reader_begin(reader, str_data, str_size);
+    uint32_t count = labpack_reader_begin_array(reader);
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t length = 0;
+        labpack_read_str_into(reader, buffer, sizeof(buffer), &length);
+        total += length;
+    }
+    labpack_reader_end_array(reader);
+    labpack_reader_end(reader);
+    sink += total;
+}
+
+static void
+raw_read_map()
+{
+    char key[16];
+    mpack_reader_t decoder;
+    mpack_reader_init_data(&decoder, map_data, map_size);
+    uint32_t count = mpack_expect_array(&decoder);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        mpack_expect_map(&decoder);
+        uint32_t length = mpack_expect_str_max(&decoder, sizeof(key));
+        mpack_read_bytes(&decoder, key, length);
+        mpack_done_str(&decoder);
+        sum += mpack_expect_u32(&decoder);
+        mpack_done_map(&decoder);
+    }
+    mpack_done_array(&decoder);
+    mpack_reader_destroy(&decoder);
+    sink += (double)sum;
+}
+
+static void
+labpack_read_maps()
+{
+    char key[16];
+    labpack_reader_begin(reader, map_data, map_size);
+    uint32_t count = labpack_reader_begin_array(reader);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        labpack_reader_begin_map(reader);
+        labpack_read_str_into(reader, key, sizeof(key), NULL);
+        sum += labpack_read_u32(reader);
+        labpack_reader_end_map(reader);
+    }
+    labpack_reader_end_array(reader);
+    labpack_reader_end(reader);
+    sink += (double)sum;
+}
+
+static const workload_t WORKLOADS[] = {
+    {"write_u8", VALUES_COUNT, raw_write_u8, labpack_write_u8s},
+    {"write_double", VALUES_COUNT, raw_write_double, labpack_write_doubles},
+    {"write_str", VALUES_COUNT, raw_write_str, labpack_write_strs},
+    {"write_map", VALUES_COUNT, raw_write_map, labpack_write_maps},
+    {"read_u8", VALUES_COUNT, raw_read_u8, labpack_read_u8s},
+    {"read_double", VALUES_COUNT, raw_read_double, labpack_read_doubles},
+    {"read_str", VALUES_COUNT, raw_read_str, labpack_read_strs},
+    {"read_map", VALUES_COUNT, raw_read_map, labpack_read_maps}
+};
+
+/**
+ * Copies the message of the last labpack write workload, so it can be read
+ * back by the matching read workload.
+ */
+static char*
+copy_message(void (*encode)(void), size_t* size)
+{
+    encode();
+    *size = labpack_writer_buffer_size(writer);
+    char* data = malloc(*size);
+    if (data) {
+        labpack_writer_buffer_data(writer, data);
+    }
+    return data;
+}
+
+static double
+seconds(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static double
+ns_per_call(void (*run)(void), uint32_t calls, double minimum, uint32_t* iterations)
+{
+    *iterations = 0;
+    clock_t start = clock();
+    do {
+        run();
+        *iterations += 1;
+    } while (seconds(start) < minimum);
+    return seconds(start) * 1.0e9 / ((double)calls * *iterations);
+}
+
+int
+main(int argc, char* argv[])
+{
+    double minimum = argc > 1 ? strtod(argv[1], NULL) : 0.5;
+    writer = labpack_writer_create();
+    reader = labpack_reader_create();
+    u8_data = copy_message(labpack_write_u8s, &u8_size);
+    double_data = copy_message(labpack_write_doubles, &double_size);
+    str_data = copy_message(labpack_write_strs, &str_size);
+    map_data = copy_message(labpack_write_maps, &map_size);
+    if (labpack_writer_is_error(writer) || !u8_data || !double_data || !str_data || !map_data) {
+        fprintf(stderr, "Setup failed: %s\n", labpack_writer_status_message(writer));
+        return 1;
+    }
+    size_t workloads = sizeof(WORKLOADS) / sizeof(WORKLOADS[0]);
+    printf("{\n  \"version\": \"%s\",\n  \"results\": [\n", labpack_version());
+    for (size_t w = 0; w < workloads; w++) {
+        const workload_t* workload = &WORKLOADS[w];
+        uint32_t raw_iterations = 0;
+        uint32_t wrapped_iterations = 0;
+        double raw = ns_per_call(workload->raw, workload->calls, minimum, &raw_iterations);
+        double wrapped = ns_per_call(workload->wrapped, workload->calls, minimum, &wrapped_iterations);
+        if (labpack_writer_is_error(writer) || labpack_reader_is_error(reader)) {
+            fprintf(stderr, "The %s workload failed\n", workload->name);
+            return 1;
+        }
+        printf("    {\"workload\": \"%s\", \"calls\": %u, \"mpack_iterations\": %u, \"labpack_iterations\": %u, "
+               "\"mpack_ns_per_call\": %.3f, \"labpack_ns_per_call\": %.3f, \"overhead_ns_per_call\": %.3f, "
+               "\"ratio\": %.2f}%s\n",
+               workload->name, workload->calls, raw_iterations, wrapped_iterations, raw, wrapped, wrapped - raw,
+               wrapped / raw, w + 1 == workloads ? "" : ",");
+    }
+    printf("  ]\n}\n");
+    free(map_data);
+    free(str_data);
+    free(double_data);
+    free(u8_data);
+    labpack_reader_destroy(reader);
+    labpack_writer_destroy(writer);
+    return 0;
+}
@@ -0,0 +1,34 @@
+# Trains a profile-guided build with the benchmark suite, which encodes and
+# decodes every corpus. Run by the LABPACK_PGO option with:
+#
+#   TRAINER       the instrumented labpack_bench executable
+#   PROFILE_DIR   the directory of the profile
+#   PROFDATA      the llvm-profdata executable for Clang, or empty for GCC
+#   STAMP         the file written once the profile is complete
+
+# The counters of GCC accumulate across runs, so each build starts over
+file(REMOVE_RECURSE ${PROFILE_DIR})
+file(MAKE_DIRECTORY ${PROFILE_DIR})
+
+# A short run is enough to find the hot paths, which do not depend on time
+execute_process(
+    COMMAND ${TRAINER} 0.05
+    OUTPUT_FILE ${PROFILE_DIR}/training.json
+    RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "The training workload failed: ${result}")
+endif()
+
+if(PROFDATA)
+    file(GLOB raw_profiles ${PROFILE_DIR}/*.profraw)
+    execute_process(
+        COMMAND ${PROFDATA} merge -output=${PROFILE_DIR}/labpack.profdata ${raw_profiles}
+        RESULT_VARIABLE result
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Merging the training profile failed: ${result}")
+    endif()
+endif()
+
+file(WRITE ${STAMP} "")
@@ -0,0 +1,422 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+
+/*
+ * Measures encoding and decoding throughput over corpora modeled on common
+ * LabVIEW payloads and prints the results as JSON, so runs from different
+ * versions can be compared.
+ *
+ * Usage: labpack_bench [seconds]
+ *
+ * Each corpus and operation is repeated for at least the given number of
+ * seconds of processor time, which is 0.5 by default.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "labpack.h"
+
+#define WIDE_FIELDS_COUNT 64
+#define WAVEFORM_SAMPLES_COUNT (1024 * 1024)
+#define CONFIG_DEPTH 6
+
+typedef struct {
+    const char* name;
+    uint32_t messages;
+    void (*encode)(labpack_writer_t* writer, uint32_t index);
+    void (*decode)(labpack_reader_t* reader);
+} corpus_t;
+
+// Keeps the decoded values alive, so the decoding is not optimized away.
+static volatile double sink = 0.0;
+
+static const char* STATUS_NAMES[] = {"state", "code", "ok", "time"};
+static const char* STATES[] = {"Idle", "Running", "Fault"};
+static labpack_keyset_t* status_keys = NULL;
+
+static char wide_names[WIDE_FIELDS_COUNT][8];
+static labpack_schema_t* wide_schema = NULL;
+
+static char* waveform = NULL;
+
+static const char* LEVELS[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+
+static void
+encode_status(labpack_writer_t* writer, uint32_t index)
+{
+    labpack_writer_begin_map(writer, 4);
+    labpack_write_cstr(writer, STATUS_NAMES[0]);
+    labpack_write_cstr(writer, STATES[index % 3]);
+    labpack_write_cstr(writer, STATUS_NAMES[1]);
+    labpack_write_i32(writer, (int32_t)(index % 500));
+    labpack_write_cstr(writer, STATUS_NAMES[2]);
+    labpack_write_bool(writer, index % 7 != 0);
+    labpack_write_cstr(writer, STATUS_NAMES[3]);
+    labpack_write_double(writer, index * 0.001);
+    labpack_writer_end_map(writer);
+}
+
+static void
+decode_status(labpack_reader_t* reader)
+{
+    char state[16];
+    uint32_t length = 0;
+    uint32_t fields = labpack_reader_begin_map(reader);
+    for (uint32_t i = 0; i < fields; i++) {
+        switch (labpack_reader_expect_key(reader, status_keys)) {
+            case 0: labpack_read_str_into(reader, state, sizeof(state), &length); break;
+            case 1: sink += labpack_read_i32(reader); break;
+            case 2: sink += labpack_read_bool(reader); break;
+            case 3: sink += labpack_read_double(reader); break;
+            default: labpack_reader_skip(reader, 1);
+        }
+    }
+    labpack_reader_end_map(reader);
+}
+
+static void
+encode_wide(labpack_writer_t* writer, uint32_t index)
+{
+    labpack_writer_begin_map(writer, WIDE_FIELDS_COUNT);
+    for (uint32_t i = 0; i < WIDE_FIELDS_COUNT; i++) {
+        labpack_write_cstr(writer, wide_names[i]);
+        labpack_write_double(writer, index + i * 0.25);
+    }
+    labpack_writer_end_map(writer);
+}
+
+static void
+decode_wide(labpack_reader_t* reader)
+{
+    double record[WIDE_FIELDS_COUNT];
+    labpack_read_record(reader, wide_schema, record);
+    sink += record[WIDE_FIELDS_COUNT - 1];
+}
+
+static void
+encode_waveform(labpack_writer_t* writer, uint32_t index)
+{
+    labpack_writer_begin_map(writer, 3);
+    labpack_write_cstr(writer, "t0");
+    labpack_write_double(writer, index * 1.0);
+    labpack_write_cstr(writer, "dt");
+    labpack_write_double(writer, 1.0e-6);
+    labpack_write_cstr(writer, "Y");
+    labpack_writer_begin_array(writer, WAVEFORM_SAMPLES_COUNT);
+    for (uint32_t i = 0; i < WAVEFORM_SAMPLES_COUNT; i++) {
+        labpack_write_double(writer, (i % 1000) * 0.001 - 0.5);
+    }
+    labpack_writer_end_array(writer);
+    labpack_writer_end_map(writer);
+}
+
+static void
+decode_waveform(labpack_reader_t* reader)
+{
+    char key[4];
+    uint32_t length = 0;
+    labpack_reader_begin_map(reader);
+    labpack_read_str_into(reader, key, sizeof(key), &length);
+    sink += labpack_read_double(reader);
+    labpack_read_str_into(reader, key, sizeof(key), &length);
+    sink += labpack_read_double(reader);
+    labpack_read_str_into(reader, key, sizeof(key), &length);
+    sink += labpack_read_lv_array_double(reader, waveform, labpack_lv_array_size(sizeof(double), WAVEFORM_SAMPLES_COUNT));
+    labpack_reader_end_map(reader);
+}
+
+static void
+encode_log(labpack_writer_t* writer, uint32_t index)
+{
+    char message[128];
+    snprintf(message, sizeof(message), "Acquired sample %u on channel %u with status nominal and no warnings", index, index % 32);
+    labpack_writer_begin_array(writer, 4);
+    labpack_write_u64(writer, 1500000000000ull + index);
+    labpack_write_cstr(writer, LEVELS[index % 4]);
+    labpack_write_cstr(writer, "Acquisition.lvlib:Main Loop.vi");
+    labpack_write_cstr(writer, message);
+    labpack_writer_end_array(writer);
+}
+
+static void
+decode_log(labpack_reader_t* reader)
+{
+    char text[128];
+    uint32_t length = 0;
+    labpack_reader_begin_array(reader);
+    sink += (double)labpack_read_u64(reader);
+    for (uint32_t i = 0; i < 3; i++) {
+        labpack_read_str_into(reader, text, sizeof(text), &length);
+        sink += length;
+    }
+    labpack_reader_end_array(reader);
+}
+
+static void
+encode_section(labpack_writer_t* writer, uint32_t depth, uint32_t index)
+{
+    static const char* CHILDREN[] = {"input", "output", "timing"};
+    labpack_writer_begin_map(writer, depth > 0 ? 6 : 3);
+    labpack_write_cstr(writer, "name");
+    labpack_write_cstr(writer, "Section");
+    labpack_write_cstr(writer, "enabled");
+    labpack_write_bool(writer, (depth + index) % 2 == 0);
+    labpack_write_cstr(writer, "limit");
+    labpack_write_double(writer, depth * 10.0 + index);
+    if (depth > 0) {
+        for (uint32_t i = 0; i < 3; i++) {
+            labpack_write_cstr(writer, CHILDREN[i]);
+            encode_section(writer, depth - 1, index);
+        }
+    }
+    labpack_writer_end_map(writer);
+}
+
+static void
+encode_config(labpack_writer_t* writer, uint32_t index)
+{
+    encode_section(writer, CONFIG_DEPTH, index);
+}
+
+/**
+ * Decodes any value without knowing its structure, like a configuration
+ * loader.
+ */
+static void
+decode_any(labpack_reader_t* reader)
+{
+    char text[64];
+    uint32_t length = 0;
+    labpack_type_t type = LABPACK_TYPE_NIL;
+    uint32_t count = 0;
+    labpack_reader_peek(reader, &type, &count);
+    switch (type) {
+        case LABPACK_TYPE_MAP:
+            labpack_reader_begin_map(reader);
+            for (uint32_t i = 0; i < count; i++) {
+                labpack_read_str_into(reader, text, sizeof(text), &length);
+                decode_any(reader);
+            }
+            labpack_reader_end_map(reader);
+            break;
+        case LABPACK_TYPE_ARRAY:
+            labpack_reader_begin_array(reader);
+            for (uint32_t i = 0; i < count; i++) {
+                decode_any(reader);
+            }
+            labpack_reader_end_array(reader);
+            break;
+        case LABPACK_TYPE_STR:
+            labpack_read_str_into(reader, text, sizeof(text), &length);
+            break;
+        case LABPACK_TYPE_BOOL: sink += labpack_read_bool(reader); break;
+        case LABPACK_TYPE_INT: sink += (double)labpack_read_i64(reader); break;
+        case LABPACK_TYPE_UINT: sink += (double)labpack_read_u64(reader); break;
+        case LABPACK_TYPE_FLOAT:
+        case LABPACK_TYPE_DOUBLE: sink += labpack_read_double(reader); break;
+        default: labpack_reader_skip(reader, 1);
+    }
+}
+
+static const corpus_t CORPORA[] = {
+    {"status_maps", 100000, encode_status, decode_status},
+    {"wide_records", 10000, encode_wide, decode_wide},
+    {"waveform", 1, encode_waveform, decode_waveform},
+    {"string_logs", 50000, encode_log, decode_log},
+    {"nested_config", 100, encode_config, decode_any},
+};
+
+static uint64_t
+count_elements(labpack_reader_t* reader)
+{
+    labpack_type_t type = LABPACK_TYPE_NIL;
+    uint32_t count = 0;
+    uint64_t total = 1;
+    labpack_reader_peek(reader, &type, &count);
+    switch (type) {
+        case LABPACK_TYPE_MAP:
+            labpack_reader_begin_map(reader);
+            for (uint32_t i = 0; i < count * 2; i++) {
+                total += count_elements(reader);
+            }
+            labpack_reader_end_map(reader);
+            break;
+        case LABPACK_TYPE_ARRAY:
+            labpack_reader_begin_array(reader);
+            for (uint32_t i = 0; i < count; i++) {
+                total += count_elements(reader);
+            }
+            labpack_reader_end_array(reader);
+            break;
+        default:
+            labpack_reader_skip(reader, 1);
+    }
+    return total;
+}
+
+static bool
+setup()
+{
+    status_keys = labpack_keyset_create(STATUS_NAMES, 4);
+    labpack_field_t fields[WIDE_FIELDS_COUNT];
+    for (uint32_t i = 0; i < WIDE_FIELDS_COUNT; i++) {
+        snprintf(wide_names[i], sizeof(wide_names[i]), "field%02u", i);
+        fields[i].name = wide_names[i];
+        fields[i].type = LABPACK_TYPE_DOUBLE;
+        fields[i].offset = i * sizeof(double);
+        fields[i].size = sizeof(double);
+    }
+    wide_schema = labpack_schema_create(fields, WIDE_FIELDS_COUNT);
+    waveform = malloc(labpack_lv_array_size(sizeof(double), WAVEFORM_SAMPLES_COUNT));
+    return labpack_keyset_is_ok(status_keys) && labpack_schema_is_ok(wide_schema) && waveform;
+}
+
+static void
+teardown()
+{
+    labpack_keyset_destroy(status_keys);
+    labpack_schema_destroy(wide_schema);
+    free(waveform);
+}
+
+/**
+ * Encodes every message of the corpus, each with its own begin and end, and
+ * copies it out like a caller sending it. Returns the total number of bytes.
+ */
+static size_t
+encode_corpus(labpack_writer_t* writer, const corpus_t* corpus, char* data, size_t capacity)
+{
+    size_t size = 0;
+    for (uint32_t i = 0; i < corpus->messages && labpack_writer_is_ok(writer); i++) {
+        labpack_writer_begin(writer);
+        corpus->encode(writer, i);
+        labpack_writer_end(writer);
+        size_t length = labpack_writer_buffer_size(writer);
+        if (data && size + length <= capacity) {
+            labpack_writer_buffer_data(writer, data + size);
+        }
+        size += length;
+    }
+    return size;
+}
+
+static void
+decode_corpus(labpack_reader_t* reader, const corpus_t* corpus, const char* data, size_t size)
+{
+    labpack_reader_begin(reader, data, size);
+    while (labpack_reader_next_message(reader)) {
+        corpus->decode(reader);
+    }
+    labpack_reader_end(reader);
+}
+
+static double
+seconds(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void
+report(const corpus_t* corpus, const char* operation, size_t size, uint64_t elements, uint32_t iterations, double elapsed, bool last)
+{
+    double megabytes = (double)size * iterations / (1024.0 * 1024.0);
+    printf("    {\"corpus\": \"%s\", \"operation\": \"%s\", \"bytes\": %zu, \"messages\": %u, "
+           "\"elements\": %llu, \"iterations\": %u, \"seconds\": %.6f, \"mb_per_s\": %.2f, "
+           "\"messages_per_s\": %.1f, \"ns_per_element\": %.3f}%s\n",
+           corpus->name, operation, size, corpus->messages, (unsigned long long)elements, iterations, elapsed,
+           megabytes / elapsed, (double)corpus->messages * iterations / elapsed,
+           elapsed * 1.0e9 / ((double)elements * iterations), last ? "" : ",");
+}
+
+int
+main(int argc, char* argv[])
+{
+    double minimum = argc > 1 ? strtod(argv[1], NULL) : 0.5;
+    if (!setup()) {
+        fprintf(stderr, "Setup failed\n");
+        return 1;
+    }
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_reader_t* reader = labpack_reader_create();
+    size_t corpora = sizeof(CORPORA) / sizeof(CORPORA[0]);
+    printf("{\n  \"version\": \"%s\",\n  \"results\": [\n", labpack_version());
+    for (size_t c = 0; c < corpora; c++) {
+        const corpus_t* corpus = &CORPORA[c];
+        size_t size = encode_corpus(writer, corpus, NULL, 0);
+        char* data = malloc(size);
+        encode_corpus(writer, corpus, data, size);
+        if (labpack_writer_is_error(writer) || !data) {
+            fprintf(stderr, "Encoding %s failed: %s\n", corpus->name, labpack_writer_status_message(writer));
+            return 1;
+        }
+        uint64_t elements = 0;
+        labpack_reader_begin(reader, data, size);
+        while (labpack_reader_next_message(reader)) {
+            elements += count_elements(reader);
+        }
+        labpack_reader_end(reader);
+
+        uint32_t iterations = 0;
+        clock_t start = clock();
+        do {
+            encode_corpus(writer, corpus, data, size);
+            iterations++;
+        } while (seconds(start) < minimum && labpack_writer_is_ok(writer));
+        report(corpus, "encode", size, elements, iterations, seconds(start), false);
+
+        iterations = 0;
+        start = clock();
+        do {
+            decode_corpus(reader, corpus, data, size);
+            iterations++;
+        } while (seconds(start) < minimum && labpack_reader_is_ok(reader));
+        double elapsed = seconds(start);
+        if (labpack_reader_is_error(reader)) {
+            fprintf(stderr, "Decoding %s failed: %s\n", corpus->name, labpack_reader_status_message(reader));
+            return 1;
+        }
+        report(corpus, "decode", size, elements, iterations, elapsed, c + 1 == corpora);
+        free(data);
+    }
+    printf("  ]\n}\n");
+    labpack_reader_destroy(reader);
+    labpack_writer_destroy(writer);
+    teardown();
+    return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+/*
+ * Measures the throughput of the labpack_validate function against fully
+ * decoding the same data with a reader.
+ *
+ * Usage: bench_validate [records] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "labpack.h"
+
+static const char* NAMES[] = {"id", "name", "value", "valid", "samples"};
+static const uint32_t SAMPLES_COUNT = 8;
+
+static char*
+encode(uint32_t records, size_t* size)
+{
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_writer_begin(writer);
+    labpack_writer_begin_array(writer, records);
+    for (uint32_t i = 0; i < records; i++) {
+        labpack_writer_begin_map(writer, 5);
+        labpack_write_cstr(writer, NAMES[0]);
+        labpack_write_uint(writer, i);
+        labpack_write_cstr(writer, NAMES[1]);
+        labpack_write_cstr(writer, "Channel");
+        labpack_write_cstr(writer, NAMES[2]);
+        labpack_write_double(writer, i * 0.5);
+        labpack_write_cstr(writer, NAMES[3]);
+        labpack_write_bool(writer, i % 2 == 0);
+        labpack_write_cstr(writer, NAMES[4]);
+        labpack_writer_begin_array(writer, SAMPLES_COUNT);
+        for (uint32_t j = 0; j < SAMPLES_COUNT; j++) {
+            labpack_write_float(writer, (float)j);
+        }
+        labpack_writer_end_array(writer);
+        labpack_writer_end_map(writer);
+    }
+    labpack_writer_end_array(writer);
+    labpack_writer_end(writer);
+    *size = labpack_writer_buffer_size(writer);
+    char* data = malloc(*size);
+    labpack_writer_buffer_data(writer, data);
+    labpack_writer_destroy(writer);
+    return data;
+}
+
+static void
+decode(labpack_reader_t* reader, const char* data, size_t size)
+{
+    char key[16];
+    labpack_reader_begin(reader, data, size);
+    uint32_t records = labpack_reader_begin_array(reader);
+    for (uint32_t i = 0; i < records; i++) {
+        uint32_t fields = labpack_reader_begin_map(reader);
+        for (uint32_t j = 0; j < fields; j++) {
+            uint32_t length = labpack_reader_begin_str(reader);
+            labpack_read_bytes(reader, key, length);
+            labpack_reader_end_str(reader);
+            switch (j) {
+                case 0: labpack_read_u32(reader); break;
+                case 1:
+                    length = labpack_reader_begin_str(reader);
+                    labpack_read_bytes(reader, key, length);
+                    labpack_reader_end_str(reader);
+                    break;
+                case 2: labpack_read_double(reader); break;
+                case 3: labpack_read_bool(reader); break;
+                case 4: {
+                    uint32_t samples = labpack_reader_begin_array(reader);
+                    for (uint32_t k = 0; k < samples; k++) {
+                        labpack_read_float(reader);
+                    }
+                    labpack_reader_end_array(reader);
+                    break;
+                }
+            }
+        }
+        labpack_reader_end_map(reader);
+    }
+    labpack_reader_end_array(reader);
+    labpack_reader_end(reader);
+}
+
+static double
+seconds(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t records = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 100000;
+    uint32_t iterations = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 20;
+    size_t size = 0;
+    char* data = encode(records, &size);
+    double megabytes = (double)size * iterations / (1024.0 * 1024.0);
+
+    clock_t start = clock();
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (labpack_validate(data, size, 3, NULL) != LABPACK_STATUS_OK) {
+            fprintf(stderr, "Validation failed\n");
+            return 1;
+        }
+    }
+    double validate_time = seconds(start);
+
+    labpack_reader_t* reader = labpack_reader_create();
+    start = clock();
+    for (uint32_t i = 0; i < iterations; i++) {
+        decode(reader, data, size);
+        if (labpack_reader_is_error(reader)) {
+            fprintf(stderr, "Decoding failed: %s\n", labpack_reader_status_message(reader));
+            return 1;
+        }
+    }
+    double decode_time = seconds(start);
+    labpack_reader_destroy(reader);
+    free(data);
+
+    printf("size: %zu bytes, iterations: %u\n", size, iterations);
+    printf("validate: %.1f MB/s\n", megabytes / validate_time);
+    printf("decode: %.1f MB/s\n", megabytes / decode_time);
+    return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "labpack.h"
+#include "labpack-private.h"
+
+// Each allocation starts with its size, so the bytes can be counted when it
+// is freed. The header is 16 bytes to keep the alignment of malloc.
+#define HEADER_SIZE 16
+
+// Handles can be created and destroyed on any thread, so the process-wide
+// counters are updated atomically.
+#ifdef _WIN32
+typedef LONG64 labpack_counter_t;
+
+static labpack_counter_t labpack_counter_load(volatile labpack_counter_t* counter) { return InterlockedCompareExchange64(counter, 0, 0); }
+static labpack_counter_t labpack_counter_add(volatile labpack_counter_t* counter, labpack_counter_t value) { return InterlockedExchangeAdd64(counter, value) + value; }
+static bool labpack_counter_swap(volatile labpack_counter_t* counter, labpack_counter_t expected, labpack_counter_t value) { return InterlockedCompareExchange64(counter, value, expected) == expected; }
+#else
+typedef int64_t labpack_counter_t;
+
+static labpack_counter_t labpack_counter_load(volatile labpack_counter_t* counter) { return __atomic_load_n(counter, __ATOMIC_RELAXED); }
+static labpack_counter_t labpack_counter_add(volatile labpack_counter_t* counter, labpack_counter_t value) { return __atomic_add_fetch(counter, value, __ATOMIC_RELAXED); }
+static bool labpack_counter_swap(volatile labpack_counter_t* counter, labpack_counter_t expected, labpack_counter_t value) { return __atomic_compare_exchange_n(counter, &expected, value, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED); }
+#endif
+
+static volatile labpack_counter_t allocated_bytes = 0;
+static volatile labpack_counter_t peak_allocated_bytes = 0;
+
+static void*
+labpack_heap_allocate(void* context, size_t size)
+{
+    (void)context;
+    return malloc(size);
+}
+
+static void*
+labpack_heap_reallocate(void* context, void* pointer, size_t size)
+{
+    (void)context;
+    return realloc(pointer, size);
+}
+
+static void
+labpack_heap_release(void* context, void* pointer)
+{
+    (void)context;
+    free(pointer);
+}
+
+static const labpack_allocator_t HEAP_ALLOCATOR = {
+    labpack_heap_allocate,   // allocate
+    labpack_heap_reallocate, // reallocate
+    labpack_heap_release,    // release
+    NULL                     // context
+};
+
+static labpack_allocator_t current_allocator = {
+    labpack_heap_allocate,   // allocate
+    labpack_heap_reallocate, // reallocate
+    labpack_heap_release,    // release
+    NULL                     // context
+};
+
+void
+labpack_set_allocator(const labpack_allocator_t* allocator)
+{
+    if (allocator == NULL) {
+        current_allocator = HEAP_ALLOCATOR;
+        return;
+    }
+    assert(allocator->allocate);
+    assert(allocator->reallocate);
+    assert(allocator->release);
+    current_allocator = *allocator;
+}
+
+size_t
+labpack_allocated_bytes()
+{
+    return (size_t)labpack_counter_load(&allocated_bytes);
+}
+
+size_t
+labpack_peak_allocated_bytes()
+{
+    return (size_t)labpack_counter_load(&peak_allocated_bytes);
+}
+
+void
+labpack_reset_peak_allocated_bytes()
+{
+    labpack_counter_t peak = labpack_counter_load(&peak_allocated_bytes);
+    while (!labpack_counter_swap(&peak_allocated_bytes, peak, labpack_counter_load(&allocated_bytes))) {
+        peak = labpack_counter_load(&peak_allocated_bytes);
+    }
+}
+
+static void
+labpack_count_bytes(size_t added, size_t removed)
+{
+    labpack_counter_t current = labpack_counter_add(&allocated_bytes, (labpack_counter_t)added - (labpack_counter_t)removed);
+    labpack_counter_t peak = labpack_counter_load(&peak_allocated_bytes);
+    while (current > peak && !labpack_counter_swap(&peak_allocated_bytes, peak, current)) {
+        peak = labpack_counter_load(&peak_allocated_bytes);
+    }
+}
+
+const labpack_allocator_t*
+labpack_current_allocator()
+{
+    return &current_allocator;
+}
+
+void*
+labpack_allocate(const labpack_allocator_t* allocator, size_t size)
+{
+    assert(allocator);
+    if (size > SIZE_MAX - HEADER_SIZE) {
+        return NULL;
+    }
+    char* block = allocator->allocate(allocator->context, size + HEADER_SIZE);
+    if (block == NULL) {
+        return NULL;
+    }
+    *(size_t*)block = size;
+    labpack_count_bytes(size, 0);
+    return block + HEADER_SIZE;
+}
+
+void*
+labpack_reallocate(const labpack_allocator_t* allocator, void* pointer, size_t size)
+{
+    assert(allocator);
+    if (pointer == NULL) {
+        return labpack_allocate(allocator, size);
+    }
+    if (size > SIZE_MAX - HEADER_SIZE) {
+        return NULL;
+    }
+    char* block = (char*)pointer - HEADER_SIZE;
+    size_t previous = *(size_t*)block;
+    block = allocator->reallocate(allocator->context, block, size + HEADER_SIZE);
+    if (block == NULL) {
+        return NULL;
+    }
+    *(size_t*)block = size;
+    labpack_count_bytes(size, previous);
+    return block + HEADER_SIZE;
+}
+
+void
+labpack_release(const labpack_allocator_t* allocator, void* pointer)
+{
+    assert(allocator);
+    // Pools do not always accept NULL like free does
+    if (pointer != NULL) {
+        char* block = (char*)pointer - HEADER_SIZE;
+        labpack_count_bytes(0, *(size_t*)block);
+        allocator->release(allocator->context, block);
+    }
+}
+
+// MPack has no context for its allocations, so they always use the current
+// allocator. It only allocates when read or write tracking is enabled, and
+// the tracking is freed before a handle is reused or destroyed.
+
+void*
+labpack_mpack_malloc(size_t size)
+{
+    return labpack_allocate(&current_allocator, size);
+}
+
+void*
+labpack_mpack_realloc(void* pointer, size_t size)
+{
+    return labpack_reallocate(&current_allocator, pointer, size);
+}
+
+void
+labpack_mpack_free(void* pointer)
+{
+    labpack_release(&current_allocator, pointer);
+}
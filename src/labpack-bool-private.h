@@ -0,0 +1,73 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#ifndef LABPACK_BOOL_PRIVATE_H
+#define LABPACK_BOOL_PRIVATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Converts MessagePack false (0xc2) and true (0xc3) bytes to booleans.
+ *
+ * Returns the number of bytes converted, which is less than
+ * <code>count</code> if a byte is not a boolean.
+ */
+size_t labpack_bool_decode(const char* data, size_t count, bool* values);
+
+/**
+ * Converts MessagePack false (0xc2) and true (0xc3) bytes to bits, starting
+ * with bit <code>first</code> of the bitset. Bit i is stored in byte i / 8 at
+ * position i % 8, so the first element is the least significant bit.
+ *
+ * Returns the number of bytes converted, which is less than
+ * <code>count</code> if a byte is not a boolean.
+ */
+size_t labpack_bool_decode_bits(const char* data, size_t count, uint8_t* bits, size_t first);
+
+/**
+ * Converts booleans to MessagePack false (0xc2) and true (0xc3) bytes.
+ */
+void labpack_bool_encode(const bool* values, size_t count, char* data);
+
+/**
+ * Converts bits, starting with bit <code>first</code> of the bitset, to
+ * MessagePack false (0xc2) and true (0xc3) bytes.
+ */
+void labpack_bool_encode_bits(const uint8_t* bits, size_t first, size_t count, char* data);
+
+#endif
+
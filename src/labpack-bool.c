@@ -0,0 +1,187 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include "labpack-bool-private.h"
+
+// SSE2 is part of every x86_64 processor. Other processors use the scalar
+// loops, which the compiler is free to vectorize.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LABPACK_BOOL_SSE2 1
+#include <emmintrin.h>
+#else
+#define LABPACK_BOOL_SSE2 0
+#endif
+
+#define MSGPACK_FALSE 0xc2
+#define MSGPACK_TRUE 0xc3
+
+static bool
+labpack_bool_is_valid(uint8_t byte)
+{
+    // 0xc2 and 0xc3 only differ in the lowest bit
+    return (byte & 0xfe) == MSGPACK_FALSE;
+}
+
+static void
+labpack_bool_set_bit(uint8_t* bits, size_t index, bool value)
+{
+    uint8_t mask = (uint8_t)(1u << (index & 7));
+    if (value) {
+        bits[index >> 3] |= mask;
+    } else {
+        bits[index >> 3] &= (uint8_t)~mask;
+    }
+}
+
+static bool
+labpack_bool_get_bit(const uint8_t* bits, size_t index)
+{
+    return (bits[index >> 3] >> (index & 7)) & 1;
+}
+
+size_t
+labpack_bool_decode(const char* data, size_t count, bool* values)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    size_t i = 0;
+#if LABPACK_BOOL_SSE2
+    if (sizeof(bool) == 1) {
+        const __m128i falses = _mm_set1_epi8((char)MSGPACK_FALSE);
+        const __m128i trues = _mm_set1_epi8((char)MSGPACK_TRUE);
+        const __m128i ones = _mm_set1_epi8(1);
+        for (; i + 16 <= count; i += 16) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(bytes + i));
+            __m128i valid = _mm_or_si128(_mm_cmpeq_epi8(chunk, falses), _mm_cmpeq_epi8(chunk, trues));
+            if (_mm_movemask_epi8(valid) != 0xffff) {
+                break;
+            }
+            _mm_storeu_si128((__m128i*)(values + i), _mm_and_si128(chunk, ones));
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        if (!labpack_bool_is_valid(bytes[i])) {
+            return i;
+        }
+        values[i] = bytes[i] & 1;
+    }
+    return count;
+}
+
+size_t
+labpack_bool_decode_bits(const char* data, size_t count, uint8_t* bits, size_t first)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    size_t i = 0;
+#if LABPACK_BOOL_SSE2
+    // Whole bytes of the bitset are written at a time, so the scalar loop
+    // handles any leading elements before the first byte boundary.
+    for (; i < count && ((first + i) & 7) != 0; i++) {
+        if (!labpack_bool_is_valid(bytes[i])) {
+            return i;
+        }
+        labpack_bool_set_bit(bits, first + i, bytes[i] & 1);
+    }
+    const __m128i falses = _mm_set1_epi8((char)MSGPACK_FALSE);
+    const __m128i trues = _mm_set1_epi8((char)MSGPACK_TRUE);
+    for (; i + 16 <= count; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(bytes + i));
+        __m128i is_true = _mm_cmpeq_epi8(chunk, trues);
+        __m128i valid = _mm_or_si128(_mm_cmpeq_epi8(chunk, falses), is_true);
+        if (_mm_movemask_epi8(valid) != 0xffff) {
+            break;
+        }
+        int mask = _mm_movemask_epi8(is_true);
+        size_t index = (first + i) >> 3;
+        bits[index] = (uint8_t)mask;
+        bits[index + 1] = (uint8_t)(mask >> 8);
+    }
+#endif
+    for (; i < count; i++) {
+        if (!labpack_bool_is_valid(bytes[i])) {
+            return i;
+        }
+        labpack_bool_set_bit(bits, first + i, bytes[i] & 1);
+    }
+    return count;
+}
+
+void
+labpack_bool_encode(const bool* values, size_t count, char* data)
+{
+    uint8_t* bytes = (uint8_t*)data;
+    size_t i = 0;
+#if LABPACK_BOOL_SSE2
+    if (sizeof(bool) == 1) {
+        const __m128i zeros = _mm_setzero_si128();
+        const __m128i trues = _mm_set1_epi8((char)MSGPACK_TRUE);
+        for (; i + 16 <= count; i += 16) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(values + i));
+            // Adding the all ones (-1) of a false element turns 0xc3 into 0xc2
+            __m128i is_false = _mm_cmpeq_epi8(chunk, zeros);
+            _mm_storeu_si128((__m128i*)(bytes + i), _mm_add_epi8(trues, is_false));
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        bytes[i] = values[i] ? MSGPACK_TRUE : MSGPACK_FALSE;
+    }
+}
+
+void
+labpack_bool_encode_bits(const uint8_t* bits, size_t first, size_t count, char* data)
+{
+    uint8_t* bytes = (uint8_t*)data;
+    size_t i = 0;
+#if LABPACK_BOOL_SSE2
+    for (; i < count && ((first + i) & 7) != 0; i++) {
+        bytes[i] = labpack_bool_get_bit(bits, first + i) ? MSGPACK_TRUE : MSGPACK_FALSE;
+    }
+    const __m128i positions = _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+    const __m128i falses = _mm_set1_epi8((char)MSGPACK_FALSE);
+    for (; i + 16 <= count; i += 16) {
+        size_t index = (first + i) >> 3;
+        // Each byte of the bitset is repeated across eight lanes and the lane's
+        // bit is isolated, so set bits become all ones (-1) and 0xc2 - -1 is 0xc3.
+        __m128i repeated = _mm_set_epi64x((long long)(bits[index + 1] * 0x0101010101010101ULL), (long long)(bits[index] * 0x0101010101010101ULL));
+        __m128i is_true = _mm_cmpeq_epi8(_mm_and_si128(repeated, positions), positions);
+        _mm_storeu_si128((__m128i*)(bytes + i), _mm_sub_epi8(falses, is_true));
+    }
+#endif
+    for (; i < count; i++) {
+        bytes[i] = labpack_bool_get_bit(bits, first + i) ? MSGPACK_TRUE : MSGPACK_FALSE;
+    }
+}
+
@@ -0,0 +1,354 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "labpack.h"
+#include "labpack-private.h"
+#include "labpack-keyset-private.h"
+
+// The number of different displacements tried for one bucket before the
+// hash seed is changed and the whole key set is rebuilt.
+#define MAX_DISPLACEMENTS (1u << 16)
+#define MAX_SEEDS 32
+
+static labpack_keyset_t OUT_OF_MEMORY_KEYSET = {
+    LABPACK_STATUS_ERROR_OUT_OF_MEMORY,              // status
+    "Not enough memory available to create key set", // status message
+    0,                                               // count
+    0,                                               // buckets
+    0,                                               // seed
+    0,                                               // max length
+    NULL,                                            // displacements
+    NULL,                                            // slots
+    NULL,                                            // offsets
+    NULL,                                            // lengths
+    NULL,                                            // names
+    { NULL, NULL, NULL, NULL }                       // allocator
+};
+
+typedef struct _labpack_bucket {
+    uint32_t id;
+    uint32_t size;
+} labpack_bucket_t;
+
+/**
+ * A seeded 64-bit FNV-1a hash. The upper half selects the bucket and the
+ * lower half is mixed with the bucket's displacement to select the slot.
+ */
+static uint64_t
+labpack_keyset_hash(const char* key, uint32_t length, uint64_t seed)
+{
+    uint64_t hash = 14695981039346656037ULL ^ seed;
+    for (uint32_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)key[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint32_t
+labpack_keyset_bucket(const labpack_keyset_t* keyset, uint64_t hash)
+{
+    return (uint32_t)(hash >> 32) % keyset->buckets;
+}
+
+static uint32_t
+labpack_keyset_slot(const labpack_keyset_t* keyset, uint64_t hash, uint32_t displacement)
+{
+    // The MurmurHash3 finalizer, so each displacement gives an unrelated slot
+    uint32_t h = (uint32_t)hash ^ (displacement * 0x9e3779b9u);
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h % keyset->count;
+}
+
+static int
+labpack_keyset_compare_buckets(const void* a, const void* b)
+{
+    const labpack_bucket_t* left = a;
+    const labpack_bucket_t* right = b;
+    if (left->size != right->size) {
+        return left->size > right->size ? -1 : 1;
+    }
+    return left->id < right->id ? -1 : (left->id > right->id);
+}
+
+static bool
+labpack_keyset_equals(const labpack_keyset_t* keyset, uint32_t index, const char* key, uint32_t length)
+{
+    return keyset->lengths[index] == length && memcmp(keyset->names + keyset->offsets[index], key, length) == 0;
+}
+
+static void
+labpack_keyset_fail(labpack_keyset_t* keyset, labpack_status_t status, const char* message)
+{
+    keyset->status = status;
+    keyset->status_message = message;
+}
+
+/**
+ * Builds the minimal perfect hash with the "hash, displace, and compress"
+ * approach: keys are grouped into buckets and, largest bucket first, each
+ * bucket searches for a displacement that places all of its keys into free
+ * slots. Returns false if a bucket could not be placed with this seed.
+ */
+static bool
+labpack_keyset_build(labpack_keyset_t* keyset, uint64_t* hashes, uint32_t* members, uint32_t* starts, labpack_bucket_t* order, uint8_t* taken)
+{
+    uint32_t count = keyset->count;
+    uint32_t buckets = keyset->buckets;
+    for (uint32_t i = 0; i < count; i++) {
+        const char* name = keyset->names + keyset->offsets[i];
+        hashes[i] = labpack_keyset_hash(name, keyset->lengths[i], keyset->seed);
+    }
+    memset(starts, 0, (buckets + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        starts[labpack_keyset_bucket(keyset, hashes[i]) + 1] += 1;
+    }
+    for (uint32_t b = 0; b < buckets; b++) {
+        order[b].id = b;
+        order[b].size = starts[b + 1];
+        starts[b + 1] += starts[b];
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t b = labpack_keyset_bucket(keyset, hashes[i]);
+        members[starts[b] + order[b].size - 1] = i;
+        order[b].size -= 1;
+    }
+    for (uint32_t b = 0; b < buckets; b++) {
+        order[b].size = starts[b + 1] - starts[b];
+        for (uint32_t i = starts[b]; i < starts[b + 1]; i++) {
+            for (uint32_t j = starts[b]; j < i; j++) {
+                uint32_t name = members[i];
+                if (hashes[name] == hashes[members[j]] && labpack_keyset_equals(keyset, members[j], keyset->names + keyset->offsets[name], keyset->lengths[name])) {
+                    labpack_keyset_fail(keyset, LABPACK_STATUS_ERROR_INVALID_ARGUMENT, "The names must be unique");
+                    return false;
+                }
+            }
+        }
+    }
+    qsort(order, buckets, sizeof(labpack_bucket_t), labpack_keyset_compare_buckets);
+    memset(taken, 0, count);
+    for (uint32_t o = 0; o < buckets && order[o].size > 0; o++) {
+        uint32_t b = order[o].id;
+        uint32_t displacement = 0;
+        for (; displacement < MAX_DISPLACEMENTS; displacement++) {
+            uint32_t placed = starts[b];
+            for (; placed < starts[b + 1]; placed++) {
+                uint32_t slot = labpack_keyset_slot(keyset, hashes[members[placed]], displacement);
+                if (taken[slot]) {
+                    break;
+                }
+                taken[slot] = 1;
+            }
+            if (placed == starts[b + 1]) {
+                break;
+            }
+            for (uint32_t i = starts[b]; i < placed; i++) {
+                taken[labpack_keyset_slot(keyset, hashes[members[i]], displacement)] = 0;
+            }
+        }
+        if (displacement == MAX_DISPLACEMENTS) {
+            return false;
+        }
+        keyset->displacements[b] = displacement;
+        for (uint32_t i = starts[b]; i < starts[b + 1]; i++) {
+            keyset->slots[labpack_keyset_slot(keyset, hashes[members[i]], displacement)] = members[i];
+        }
+    }
+    return true;
+}
+
+static void
+labpack_keyset_init(labpack_keyset_t* keyset, const char** names, uint32_t count)
+{
+    keyset->status = LABPACK_STATUS_OK;
+    keyset->status_message = labpack_status_string(keyset->status);
+    keyset->count = count;
+    keyset->buckets = count / 2 + 1;
+    keyset->seed = 0;
+    keyset->max_length = 0;
+    keyset->displacements = NULL;
+    keyset->slots = NULL;
+    keyset->offsets = NULL;
+    keyset->lengths = NULL;
+    keyset->names = NULL;
+    if (names == NULL && count > 0) {
+        labpack_keyset_fail(keyset, LABPACK_STATUS_ERROR_NULL_VALUE, "The names cannot be NULL");
+        return;
+    }
+    if (count > INT32_MAX) {
+        labpack_keyset_fail(keyset, LABPACK_STATUS_ERROR_INVALID_ARGUMENT, "Too many names");
+        return;
+    }
+    size_t total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (names[i] == NULL) {
+            labpack_keyset_fail(keyset, LABPACK_STATUS_ERROR_NULL_VALUE, "The names cannot be NULL");
+            return;
+        }
+        size_t length = strlen(names[i]);
+        if (length > UINT32_MAX) {
+            labpack_keyset_fail(keyset, LABPACK_STATUS_ERROR_INVALID_ARGUMENT, "A name is too long");
+            return;
+        }
+        if (length > keyset->max_length) {
+            keyset->max_length = (uint32_t)length;
+        }
+        total += length;
+    }
+    const labpack_allocator_t* allocator = &keyset->allocator;
+    keyset->displacements = labpack_allocate(allocator, keyset->buckets * sizeof(uint32_t));
+    if (keyset->displacements) {
+        memset(keyset->displacements, 0, keyset->buckets * sizeof(uint32_t));
+    }
+    keyset->slots = labpack_allocate(allocator, (count > 0 ? count : 1) * sizeof(uint32_t));
+    keyset->offsets = labpack_allocate(allocator, (count > 0 ? count : 1) * sizeof(size_t));
+    keyset->lengths = labpack_allocate(allocator, (count > 0 ? count : 1) * sizeof(uint32_t));
+    keyset->names = labpack_allocate(allocator, total > 0 ? total : 1);
+    uint64_t* hashes = labpack_allocate(allocator, (count > 0 ? count : 1) * sizeof(uint64_t));
+    uint32_t* members = labpack_allocate(allocator, (count > 0 ? count : 1) * sizeof(uint32_t));
+    uint32_t* starts = labpack_allocate(allocator, (keyset->buckets + 1) * sizeof(uint32_t));
+    labpack_bucket_t* order = labpack_allocate(allocator, keyset->buckets * sizeof(labpack_bucket_t));
+    uint8_t* taken = labpack_allocate(allocator, count > 0 ? count : 1);
+    if (keyset->displacements && keyset->slots && keyset->offsets && keyset->lengths && keyset->names && hashes && members && starts && order && taken) {
+        size_t offset = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t length = (uint32_t)strlen(names[i]);
+            memcpy(keyset->names + offset, names[i], length);
+            keyset->offsets[i] = offset;
+            keyset->lengths[i] = length;
+            offset += length;
+        }
+        bool built = false;
+        for (uint32_t attempt = 0; attempt < MAX_SEEDS && !built && keyset->status == LABPACK_STATUS_OK; attempt++) {
+            keyset->seed = attempt * 0x9e3779b97f4a7c15ULL;
+            built = labpack_keyset_build(keyset, hashes, members, starts, order, taken);
+        }
+        if (!built && keyset->status == LABPACK_STATUS_OK) {
+            labpack_keyset_fail(keyset, LABPACK_STATUS_ERROR_INVALID_ARGUMENT, "Unable to build a perfect hash for the names");
+        }
+    } else {
+        labpack_keyset_fail(keyset, LABPACK_STATUS_ERROR_OUT_OF_MEMORY, "Not enough memory available to build key set");
+    }
+    labpack_release(allocator, hashes);
+    labpack_release(allocator, members);
+    labpack_release(allocator, starts);
+    labpack_release(allocator, order);
+    labpack_release(allocator, taken);
+}
+
+labpack_keyset_t*
+labpack_keyset_create(const char** names, uint32_t count)
+{
+    const labpack_allocator_t* allocator = labpack_current_allocator();
+    labpack_keyset_t* keyset = labpack_allocate(allocator, sizeof(labpack_keyset_t));
+    if (keyset == NULL) {
+        return &OUT_OF_MEMORY_KEYSET;
+    }
+    keyset->allocator = *allocator;
+    labpack_keyset_init(keyset, names, count);
+    return keyset;
+}
+
+void
+labpack_keyset_destroy(labpack_keyset_t* keyset)
+{
+    if (keyset == NULL || keyset == &OUT_OF_MEMORY_KEYSET) {
+        return;
+    }
+    labpack_allocator_t allocator = keyset->allocator;
+    labpack_release(&allocator, keyset->displacements);
+    labpack_release(&allocator, keyset->slots);
+    labpack_release(&allocator, keyset->offsets);
+    labpack_release(&allocator, keyset->lengths);
+    labpack_release(&allocator, keyset->names);
+    labpack_release(&allocator, keyset);
+}
+
+labpack_status_t
+labpack_keyset_status(labpack_keyset_t* keyset)
+{
+    assert(keyset);
+    return keyset->status;
+}
+
+const char*
+labpack_keyset_status_message(labpack_keyset_t* keyset)
+{
+    assert(keyset);
+    return keyset->status_message;
+}
+
+bool
+labpack_keyset_is_ok(labpack_keyset_t* keyset)
+{
+    assert(keyset);
+    return keyset->status == LABPACK_STATUS_OK;
+}
+
+bool
+labpack_keyset_is_error(labpack_keyset_t* keyset)
+{
+    assert(keyset);
+    return keyset->status != LABPACK_STATUS_OK;
+}
+
+uint32_t
+labpack_keyset_count(labpack_keyset_t* keyset)
+{
+    assert(keyset);
+    return keyset->count;
+}
+
+int32_t
+labpack_keyset_find(const labpack_keyset_t* keyset, const char* key, uint32_t length)
+{
+    assert(keyset);
+    if (keyset->status != LABPACK_STATUS_OK || keyset->count == 0 || length > keyset->max_length) {
+        return -1;
+    }
+    uint64_t hash = labpack_keyset_hash(key, length, keyset->seed);
+    uint32_t displacement = keyset->displacements[labpack_keyset_bucket(keyset, hash)];
+    uint32_t index = keyset->slots[labpack_keyset_slot(keyset, hash, displacement)];
+    return labpack_keyset_equals(keyset, index, key, length) ? (int32_t)index : -1;
+}
+
@@ -0,0 +1,187 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <assert.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "labpack.h"
+#include "labpack-private.h"
+
+// Each power of two is split into this many buckets, which must be a power of
+// two itself and matches LABPACK_LATENCY_BUCKETS.
+#define SUB_BUCKET_BITS 3
+#define SUB_BUCKETS (1u << SUB_BUCKET_BITS)
+
+static uint64_t
+labpack_latency_now()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    uint64_t seconds = (uint64_t)counter.QuadPart / (uint64_t)frequency.QuadPart;
+    uint64_t remainder = (uint64_t)counter.QuadPart % (uint64_t)frequency.QuadPart;
+    return seconds * 1000000000u + remainder * 1000000000u / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+static uint32_t
+labpack_latency_bucket(uint64_t latency)
+{
+    if (latency < SUB_BUCKETS) {
+        return (uint32_t)latency;
+    }
+#if defined(__GNUC__)
+    uint32_t msb = 63 - (uint32_t)__builtin_clzll(latency);
+#else
+    uint32_t msb = SUB_BUCKET_BITS;
+    while (latency >> (msb + 1)) {
+        msb++;
+    }
+#endif
+    uint32_t shift = msb - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + (uint32_t)((latency >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t
+labpack_latency_bucket_limit(uint32_t bucket)
+{
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    if (bucket >= LABPACK_LATENCY_BUCKETS) {
+        return UINT64_MAX;
+    }
+    uint32_t shift = bucket / SUB_BUCKETS - 1;
+    uint64_t sub = bucket % SUB_BUCKETS;
+    // Wraps to zero for the last bucket, which ends at UINT64_MAX
+    return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+uint64_t
+labpack_latency_start(const labpack_histogram_t* histograms)
+{
+    return histograms ? labpack_latency_now() : 0;
+}
+
+void
+labpack_latency_stop(labpack_histogram_t* histograms, labpack_latency_t latency, uint64_t start)
+{
+    // A start of zero (0) is a message that began before enabling
+    if (!histograms || start == 0) {
+        return;
+    }
+    uint64_t now = labpack_latency_now();
+    uint64_t elapsed = now > start ? now - start : 0;
+    labpack_histogram_t* histogram = &histograms[latency];
+    histogram->counts[labpack_latency_bucket(elapsed)] += 1;
+    histogram->total += 1;
+    if (elapsed > histogram->max) {
+        histogram->max = elapsed;
+    }
+}
+
+labpack_histogram_t*
+labpack_latency_set(const labpack_allocator_t* allocator, labpack_histogram_t* histograms, bool enabled)
+{
+    assert(allocator);
+    if (!enabled) {
+        labpack_release(allocator, histograms);
+        return NULL;
+    }
+    if (!histograms) {
+        histograms = labpack_allocate(allocator, LABPACK_LATENCY_COUNT * sizeof(labpack_histogram_t));
+    }
+    if (histograms) {
+        memset(histograms, 0, LABPACK_LATENCY_COUNT * sizeof(labpack_histogram_t));
+    }
+    return histograms;
+}
+
+uint64_t
+labpack_latency_histogram(const labpack_histogram_t* histograms, labpack_latency_t latency, uint64_t* counts)
+{
+    assert(counts);
+    if (!histograms) {
+        memset(counts, 0, LABPACK_LATENCY_BUCKETS * sizeof(uint64_t));
+        return 0;
+    }
+    memcpy(counts, histograms[latency].counts, LABPACK_LATENCY_BUCKETS * sizeof(uint64_t));
+    return histograms[latency].total;
+}
+
+uint64_t
+labpack_latency_percentile(const labpack_histogram_t* histograms, labpack_latency_t latency, double percentile)
+{
+    if (!histograms || histograms[latency].total == 0) {
+        return 0;
+    }
+    const labpack_histogram_t* histogram = &histograms[latency];
+    if (percentile < 0.0) {
+        percentile = 0.0;
+    } else if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+    double target = percentile / 100.0 * (double)histogram->total;
+    uint64_t rank = (uint64_t)target;
+    if ((double)rank < target) {
+        rank += 1;
+    }
+    if (rank < 1) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket < LABPACK_LATENCY_BUCKETS; bucket++) {
+        seen += histogram->counts[bucket];
+        if (seen >= rank) {
+            uint64_t limit = labpack_latency_bucket_limit(bucket);
+            return limit < histogram->max ? limit : histogram->max;
+        }
+    }
+    return histogram->max;
+}
@@ -0,0 +1,170 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <assert.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "labpack-map-private.h"
+
+static const char EMPTY[1] = {0};
+
+#ifdef _WIN32
+
+labpack_status_t
+labpack_map_open(labpack_map_t* map, const char* path)
+{
+    assert(map);
+    assert(path);
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+    map->mapping = NULL;
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return LABPACK_STATUS_ERROR_IO;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (uint64_t)size.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return LABPACK_STATUS_ERROR_IO;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        map->data = EMPTY;
+        return LABPACK_STATUS_OK;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return LABPACK_STATUS_ERROR_IO;
+    }
+    const char* data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return LABPACK_STATUS_ERROR_IO;
+    }
+    map->data = data;
+    map->size = (size_t)size.QuadPart;
+    map->handle = file;
+    map->mapping = mapping;
+    return LABPACK_STATUS_OK;
+}
+
+void
+labpack_map_close(labpack_map_t* map)
+{
+    assert(map);
+    if (map->mapping) {
+        UnmapViewOfFile(map->data);
+        CloseHandle((HANDLE)map->mapping);
+        CloseHandle((HANDLE)map->handle);
+    }
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+    map->mapping = NULL;
+}
+
+#else
+
+labpack_status_t
+labpack_map_open(labpack_map_t* map, const char* path)
+{
+    assert(map);
+    assert(path);
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+    map->mapping = NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return LABPACK_STATUS_ERROR_IO;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (uint64_t)info.st_size > SIZE_MAX) {
+        close(fd);
+        return LABPACK_STATUS_ERROR_IO;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        map->data = EMPTY;
+        return LABPACK_STATUS_OK;
+    }
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping holds its own reference to the file.
+    close(fd);
+    if (data == MAP_FAILED) {
+        return LABPACK_STATUS_ERROR_IO;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+#endif
+    map->data = (const char*)data;
+    map->size = (size_t)info.st_size;
+    map->mapping = data;
+    return LABPACK_STATUS_OK;
+}
+
+void
+labpack_map_close(labpack_map_t* map)
+{
+    assert(map);
+    if (map->mapping) {
+        munmap(map->mapping, map->size);
+    }
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+    map->mapping = NULL;
+}
+
+#endif
+
+bool
+labpack_map_is_open(const labpack_map_t* map)
+{
+    assert(map);
+    return map->data != NULL;
+}
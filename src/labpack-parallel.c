@@ -0,0 +1,354 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "labpack.h"
+#include "labpack-private.h"
+#include "labpack-map-private.h"
+
+// The number of messages a worker decodes before handing the batch back. Small
+// messages are grouped so the queue is not locked for every message.
+#define BATCH_MESSAGES 256
+
+// Batches are closed once they contain at least this many bytes.
+#define BATCH_BYTES 65536
+
+// The number of batches per worker that can be in flight at once. This bounds
+// the memory used for boundaries and results regardless of the data size.
+#define BATCHES_PER_WORKER 4
+
+#define MAX_WORKERS 256
+
+#ifdef _WIN32
+typedef HANDLE labpack_thread_t;
+typedef SRWLOCK labpack_mutex_t;
+typedef CONDITION_VARIABLE labpack_cond_t;
+#else
+typedef pthread_t labpack_thread_t;
+typedef pthread_mutex_t labpack_mutex_t;
+typedef pthread_cond_t labpack_cond_t;
+#endif
+
+typedef struct _labpack_batch {
+    uint64_t first;
+    uint32_t count;
+    bool done;
+    size_t offsets[BATCH_MESSAGES + 1];
+    void* results[BATCH_MESSAGES];
+    labpack_status_t statuses[BATCH_MESSAGES];
+} labpack_batch_t;
+
+typedef struct _labpack_pool {
+    const char* data;
+    labpack_message_decode_t decode;
+    void* context;
+    labpack_batch_t* batches;
+    uint32_t capacity;
+    uint64_t produced;
+    uint64_t claimed;
+    uint64_t delivered;
+    bool stopping;
+    labpack_mutex_t mutex;
+    labpack_cond_t work_ready;
+    labpack_cond_t batch_done;
+} labpack_pool_t;
+
+#ifdef _WIN32
+
+static void labpack_mutex_init(labpack_mutex_t* mutex) { InitializeSRWLock(mutex); }
+static void labpack_mutex_destroy(labpack_mutex_t* mutex) { (void)mutex; }
+static void labpack_mutex_lock(labpack_mutex_t* mutex) { AcquireSRWLockExclusive(mutex); }
+static void labpack_mutex_unlock(labpack_mutex_t* mutex) { ReleaseSRWLockExclusive(mutex); }
+static void labpack_cond_init(labpack_cond_t* cond) { InitializeConditionVariable(cond); }
+static void labpack_cond_destroy(labpack_cond_t* cond) { (void)cond; }
+static void labpack_cond_wait(labpack_cond_t* cond, labpack_mutex_t* mutex) { SleepConditionVariableSRW(cond, mutex, INFINITE, 0); }
+static void labpack_cond_signal(labpack_cond_t* cond) { WakeConditionVariable(cond); }
+static void labpack_cond_broadcast(labpack_cond_t* cond) { WakeAllConditionVariable(cond); }
+
+static DWORD WINAPI labpack_pool_run(LPVOID argument);
+
+static bool
+labpack_thread_create(labpack_thread_t* thread, labpack_pool_t* pool)
+{
+    *thread = CreateThread(NULL, 0, labpack_pool_run, pool, 0, NULL);
+    return *thread != NULL;
+}
+
+static void
+labpack_thread_join(labpack_thread_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static uint32_t
+labpack_cpu_count()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (uint32_t)info.dwNumberOfProcessors;
+}
+
+#else
+
+static void labpack_mutex_init(labpack_mutex_t* mutex) { pthread_mutex_init(mutex, NULL); }
+static void labpack_mutex_destroy(labpack_mutex_t* mutex) { pthread_mutex_destroy(mutex); }
+static void labpack_mutex_lock(labpack_mutex_t* mutex) { pthread_mutex_lock(mutex); }
+static void labpack_mutex_unlock(labpack_mutex_t* mutex) { pthread_mutex_unlock(mutex); }
+static void labpack_cond_init(labpack_cond_t* cond) { pthread_cond_init(cond, NULL); }
+static void labpack_cond_destroy(labpack_cond_t* cond) { pthread_cond_destroy(cond); }
+static void labpack_cond_wait(labpack_cond_t* cond, labpack_mutex_t* mutex) { pthread_cond_wait(cond, mutex); }
+static void labpack_cond_signal(labpack_cond_t* cond) { pthread_cond_signal(cond); }
+static void labpack_cond_broadcast(labpack_cond_t* cond) { pthread_cond_broadcast(cond); }
+
+static void* labpack_pool_run(void* argument);
+
+static bool
+labpack_thread_create(labpack_thread_t* thread, labpack_pool_t* pool)
+{
+    return pthread_create(thread, NULL, labpack_pool_run, pool) == 0;
+}
+
+static void
+labpack_thread_join(labpack_thread_t thread)
+{
+    pthread_join(thread, NULL);
+}
+
+static uint32_t
+labpack_cpu_count()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t)count : 1;
+}
+
+#endif
+
+static void
+labpack_pool_decode(labpack_pool_t* pool, labpack_reader_t* reader, bool created, labpack_batch_t* batch)
+{
+    // The status of the reader is left by the last message decoded, so only
+    // the status from when it was created tells whether it can be used.
+    if (!created) {
+        for (uint32_t i = 0; i < batch->count; i++) {
+            batch->results[i] = NULL;
+            batch->statuses[i] = labpack_reader_status(reader);
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < batch->count; i++) {
+        size_t start = batch->offsets[i];
+        labpack_reader_begin(reader, pool->data + start, batch->offsets[i + 1] - start);
+        batch->results[i] = pool->decode(reader, batch->first + i, pool->context);
+        labpack_reader_end(reader);
+        batch->statuses[i] = labpack_reader_status(reader);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI
+labpack_pool_run(LPVOID argument)
+#else
+static void*
+labpack_pool_run(void* argument)
+#endif
+{
+    labpack_pool_t* pool = (labpack_pool_t*)argument;
+    labpack_reader_t* reader = labpack_reader_create();
+    bool created = labpack_reader_is_ok(reader);
+    labpack_mutex_lock(&pool->mutex);
+    while (true) {
+        while (!pool->stopping && pool->claimed == pool->produced) {
+            labpack_cond_wait(&pool->work_ready, &pool->mutex);
+        }
+        if (pool->claimed == pool->produced) {
+            break;
+        }
+        labpack_batch_t* batch = &pool->batches[pool->claimed % pool->capacity];
+        pool->claimed++;
+        labpack_mutex_unlock(&pool->mutex);
+        labpack_pool_decode(pool, reader, created, batch);
+        labpack_mutex_lock(&pool->mutex);
+        batch->done = true;
+        labpack_cond_signal(&pool->batch_done);
+    }
+    labpack_mutex_unlock(&pool->mutex);
+    labpack_reader_destroy(reader);
+    return 0;
+}
+
+// Delivers the completed batches in order. Must be called with the mutex
+// locked. The mutex is released while the callback runs.
+static void
+labpack_pool_deliver(labpack_pool_t* pool, labpack_message_deliver_t deliver)
+{
+    while (pool->delivered < pool->produced) {
+        labpack_batch_t* batch = &pool->batches[pool->delivered % pool->capacity];
+        if (!batch->done) {
+            return;
+        }
+        if (deliver) {
+            labpack_mutex_unlock(&pool->mutex);
+            for (uint32_t i = 0; i < batch->count; i++) {
+                deliver(batch->first + i, batch->statuses[i], batch->results[i], pool->context);
+            }
+            labpack_mutex_lock(&pool->mutex);
+        }
+        batch->done = false;
+        pool->delivered++;
+    }
+}
+
+labpack_status_t
+labpack_decode_parallel(const char* data, size_t size, uint32_t threads, labpack_message_decode_t decode, labpack_message_deliver_t deliver, void* context)
+{
+    if ((!data && size > 0) || !decode) {
+        return LABPACK_STATUS_ERROR_NULL_VALUE;
+    }
+    if (threads == 0) {
+        threads = labpack_cpu_count();
+    }
+    if (threads > MAX_WORKERS) {
+        threads = MAX_WORKERS;
+    }
+    labpack_pool_t pool;
+    pool.data = data;
+    pool.decode = decode;
+    pool.context = context;
+    pool.capacity = threads * BATCHES_PER_WORKER;
+    pool.produced = 0;
+    pool.claimed = 0;
+    pool.delivered = 0;
+    pool.stopping = false;
+    const labpack_allocator_t* allocator = labpack_current_allocator();
+    pool.batches = labpack_allocate(allocator, pool.capacity * sizeof(labpack_batch_t));
+    if (!pool.batches) {
+        return LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+    }
+    memset(pool.batches, 0, pool.capacity * sizeof(labpack_batch_t));
+    labpack_mutex_init(&pool.mutex);
+    labpack_cond_init(&pool.work_ready);
+    labpack_cond_init(&pool.batch_done);
+    labpack_thread_t* workers = labpack_allocate(allocator, threads * sizeof(labpack_thread_t));
+    uint32_t started = 0;
+    if (workers) {
+        while (started < threads && labpack_thread_create(&workers[started], &pool)) {
+            started++;
+        }
+    }
+    labpack_status_t status = LABPACK_STATUS_OK;
+    if (started == 0) {
+        status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+    }
+    // The calling thread splits the data at message boundaries with a
+    // skip-only scan and delivers the results, while the workers decode.
+    size_t position = 0;
+    uint64_t index = 0;
+    labpack_mutex_lock(&pool.mutex);
+    while (status == LABPACK_STATUS_OK && position < size) {
+        while (pool.produced - pool.delivered == pool.capacity) {
+            labpack_pool_deliver(&pool, deliver);
+            if (pool.produced - pool.delivered == pool.capacity) {
+                labpack_cond_wait(&pool.batch_done, &pool.mutex);
+            }
+        }
+        labpack_batch_t* batch = &pool.batches[pool.produced % pool.capacity];
+        labpack_mutex_unlock(&pool.mutex);
+        size_t start = position;
+        uint32_t count = 0;
+        while (count < BATCH_MESSAGES && position < size && position - start < BATCH_BYTES) {
+            size_t length = 0;
+            if (labpack_scan(data + position, size - position, LABPACK_MAX_DEPTH, &length) != LABPACK_STATUS_OK) {
+                status = LABPACK_STATUS_ERROR_DECODER;
+                break;
+            }
+            batch->offsets[count++] = position;
+            position += length;
+        }
+        batch->offsets[count] = position;
+        batch->first = index;
+        batch->count = count;
+        index += count;
+        labpack_mutex_lock(&pool.mutex);
+        if (count > 0) {
+            pool.produced++;
+            labpack_cond_signal(&pool.work_ready);
+        }
+        labpack_pool_deliver(&pool, deliver);
+    }
+    while (pool.delivered < pool.produced) {
+        labpack_pool_deliver(&pool, deliver);
+        if (pool.delivered < pool.produced) {
+            labpack_cond_wait(&pool.batch_done, &pool.mutex);
+        }
+    }
+    pool.stopping = true;
+    labpack_cond_broadcast(&pool.work_ready);
+    labpack_mutex_unlock(&pool.mutex);
+    for (uint32_t i = 0; i < started; i++) {
+        labpack_thread_join(workers[i]);
+    }
+    labpack_release(allocator, workers);
+    labpack_cond_destroy(&pool.batch_done);
+    labpack_cond_destroy(&pool.work_ready);
+    labpack_mutex_destroy(&pool.mutex);
+    labpack_release(allocator, pool.batches);
+    return status;
+}
+
+labpack_status_t
+labpack_decode_parallel_file(const char* path, uint32_t threads, labpack_message_decode_t decode, labpack_message_deliver_t deliver, void* context)
+{
+    if (!path) {
+        return LABPACK_STATUS_ERROR_NULL_VALUE;
+    }
+    labpack_map_t map;
+    if (labpack_map_open(&map, path) != LABPACK_STATUS_OK) {
+        return LABPACK_STATUS_ERROR_IO;
+    }
+    labpack_status_t status = labpack_decode_parallel(map.data, map.size, threads, decode, deliver, context);
+    labpack_map_close(&map);
+    return status;
+}
@@ -48,6 +48,13 @@
  */
 mpack_type_t labpack_to_mpack_type(labpack_type_t type);
 
+/**
+ * Converts a mpack type to a labpack type.
+ *
+ * Returns LABPACK_TYPE_NIL if the type is not known.
+ */
+labpack_type_t labpack_from_mpack_type(mpack_type_t type);
+
 /**
  * Converts a mpack error type to a message.
  *
@@ -55,5 +62,129 @@ mpack_type_t labpack_to_mpack_type(labpack_type_t type);
  */
 const char* labpack_mpack_error_message(mpack_error_t error);
 
+/**
+ * Gets the allocator set with <code>labpack_set_allocator</code>, which is
+ * the C heap if none has been set.
+ */
+const labpack_allocator_t* labpack_current_allocator();
+
+/**
+ * Allocates memory with an allocator, like <code>malloc</code>.
+ */
+void* labpack_allocate(const labpack_allocator_t* allocator, size_t size);
+
+/**
+ * Grows or shrinks memory from an allocator, like <code>realloc</code>.
+ *
+ * A <code>NULL</code> pointer is allocated instead.
+ */
+void* labpack_reallocate(const labpack_allocator_t* allocator, void* pointer, size_t size);
+
+/**
+ * Frees memory from an allocator, like <code>free</code>.
+ *
+ * A <code>NULL</code> pointer is ignored.
+ */
+void labpack_release(const labpack_allocator_t* allocator, void* pointer);
+
+/**
+ * The number of latency histograms of a handle, one for each
+ * labpack_latency_t.
+ */
+#define LABPACK_LATENCY_COUNT 2
+
+/**
+ * A log-bucketed histogram of latencies in nanoseconds.
+ */
+typedef struct _labpack_histogram {
+    uint64_t counts[LABPACK_LATENCY_BUCKETS];
+    uint64_t total;
+    uint64_t max;
+} labpack_histogram_t;
+
+/**
+ * Reads the monotonic clock in nanoseconds if the histograms are enabled,
+ * i.e. not NULL, and returns zero (0) otherwise.
+ */
+uint64_t labpack_latency_start(const labpack_histogram_t* histograms);
+
+/**
+ * Records the time since the start in a histogram if the histograms are
+ * enabled, i.e. not NULL, and the start is not zero (0).
+ */
+void labpack_latency_stop(labpack_histogram_t* histograms, labpack_latency_t latency, uint64_t start);
+
+/**
+ * Allocates and clears the histograms when enabling, or frees them when
+ * disabling, and returns the histograms to keep, which are NULL when
+ * disabled or out of memory.
+ */
+labpack_histogram_t* labpack_latency_set(const labpack_allocator_t* allocator, labpack_histogram_t* histograms, bool enabled);
+
+/**
+ * Copies the counts of a histogram and returns the total count. The counts
+ * are zero (0) if the histograms are not enabled.
+ */
+uint64_t labpack_latency_histogram(const labpack_histogram_t* histograms, labpack_latency_t latency, uint64_t* counts);
+
+/**
+ * Gets a percentile of a histogram in nanoseconds.
+ */
+uint64_t labpack_latency_percentile(const labpack_histogram_t* histograms, labpack_latency_t latency, double percentile);
+
+/**
+ * The outcome of resuming a scanner.
+ */
+typedef enum _labpack_scan_result {
+    LABPACK_SCAN_COMPLETE = 0,
+    LABPACK_SCAN_INCOMPLETE,
+    LABPACK_SCAN_INVALID
+} labpack_scan_result_t;
+
+/**
+ * The state of a walk over MessagePack objects that can be suspended at the
+ * end of the available data and resumed once more data is appended.
+ */
+typedef struct _labpack_scanner {
+    uint64_t parents[LABPACK_MAX_DEPTH];
+    uint64_t remaining;
+    uint64_t skip;
+    size_t position;
+    uint32_t depth;
+    uint32_t max_depth;
+    bool partial;
+} labpack_scanner_t;
+
+/**
+ * Prepares a scanner to walk an object at the start of the data.
+ *
+ * When <code>partial</code> is true, running out of data suspends the walk
+ * instead of failing it.
+ */
+void labpack_scanner_init(labpack_scanner_t* scanner, uint32_t max_depth, bool partial);
+
+/**
+ * Continues a walk from the scanner's position over the first
+ * <code>size</code> bytes of the data.
+ *
+ * Between calls, bytes may be appended to the data, and bytes before the
+ * position may be removed from the front if the position is moved back by
+ * the same amount. On LABPACK_SCAN_COMPLETE, the
+ * position is the end of the object and the scanner is ready for the next
+ * object. On LABPACK_SCAN_INCOMPLETE, more data is needed. On
+ * LABPACK_SCAN_INVALID, the position is the offset of the offending element.
+ */
+labpack_scan_result_t labpack_scanner_resume(labpack_scanner_t* scanner, const char* data, size_t size);
+
+/**
+ * Walks exactly one MessagePack object at the start of the data without
+ * decoding it.
+ *
+ * On success, the number of bytes in the object is stored in
+ * <code>length</code>. On failure, the offset of the offending element is
+ * stored in <code>length</code>. Bytes after the object are not examined.
+ */
+labpack_status_t labpack_scan(const char* data, size_t size, uint32_t max_depth, size_t* length);
+
 #endif
 
@@ -0,0 +1,82 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#ifndef LABPACK_PROBES_PRIVATE_H
+#define LABPACK_PROBES_PRIVATE_H
+
+/*
+ * Static tracepoints for the labpack provider, which can be traced with
+ * perf, bpftrace, or SystemTap when the library is built with the
+ * LABPACK_ENABLE_USDT option. Each probe is a single no-op instruction
+ * until a tracer attaches, and the probes and their arguments are compiled
+ * out entirely without the option.
+ *
+ * Probes:
+ *
+ *   writer__begin(writer)
+ *   writer__end(writer, size, status)
+ *   writer__container__begin(writer, type, count)
+ *   writer__container__end(writer, type)
+ *   writer__grow(writer, old capacity, new capacity)
+ *   writer__error(writer, mpack error, offset)
+ *   reader__begin(reader, size)
+ *   reader__next(reader, offset)
+ *   reader__end(reader, offset, status)
+ *   reader__container__begin(reader, type, count)
+ *   reader__container__end(reader, type)
+ *   reader__grow(reader, old capacity, new capacity)
+ *   reader__error(reader, mpack error, offset)
+ *
+ * The sizes, counts, and offsets are in bytes or elements, the types are
+ * labpack_type_t values, and the statuses are labpack_status_t values.
+ */
+
+#if defined(LABPACK_ENABLE_USDT) && LABPACK_ENABLE_USDT
+
+#include <sys/sdt.h>
+
+#define LABPACK_PROBE1(name, a) DTRACE_PROBE1(labpack, name, a)
+#define LABPACK_PROBE2(name, a, b) DTRACE_PROBE2(labpack, name, a, b)
+#define LABPACK_PROBE3(name, a, b, c) DTRACE_PROBE3(labpack, name, a, b, c)
+
+#else
+
+#define LABPACK_PROBE1(name, a) do { } while (0)
+#define LABPACK_PROBE2(name, a, b) do { } while (0)
+#define LABPACK_PROBE3(name, a, b, c) do { } while (0)
+
+#endif
+
+#endif
@@ -35,12 +35,39 @@
 #ifndef LABPACK_READER_PRIVATE_H
 #define LABPACK_READER_PRIVATE_H
 
+#include <stdio.h>
+
 #include "mpack.h"
 
+#include "labpack-private.h"
+#include "labpack-map-private.h"
+
 struct _labpack_reader {
     mpack_reader_t* decoder;
     labpack_status_t status;
     const char* status_message;
+    char* buffer;
+    size_t buffer_size;
+    FILE* file;
+    int fd;
+    labpack_map_t map;
+    uint64_t received;
+    uint32_t depth;
+    labpack_scanner_t* scanner;
+    size_t buffered;
+    size_t consumed;
+    bool incremental;
+    char* arena;
+    size_t arena_size;
+    size_t arena_used;
+    size_t peak_buffer;
+    size_t peak_arena;
+    size_t peak_mapped;
+    labpack_stats_t stats;
+    labpack_allocator_t allocator;
+    labpack_histogram_t* latency;
+    uint64_t started;
+    uint64_t started_elements;
 };
 
 #endif
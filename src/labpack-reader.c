@@ -33,33 +33,126 @@
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #include "mpack.h"
 
 #include "labpack.h"
 #include "labpack-private.h"
+#include "labpack-bool-private.h"
+#include "labpack-keyset-private.h"
+#include "labpack-schema-private.h"
 #include "labpack-reader-private.h"
+#include "labpack-probes-private.h"
+#include "labpack-simd-private.h"
 
 static labpack_reader_t OUT_OF_MEMORY_READER = {
-    NULL,                                          // decoder
-    LABPACK_STATUS_ERROR_OUT_OF_MEMORY,            // status
-    "Not enough memory available to create reader" // status message
+    NULL,                                           // decoder
+    LABPACK_STATUS_ERROR_OUT_OF_MEMORY,             // status
+    "Not enough memory available to create reader", // status message
+    NULL,                                           // buffer
+    0,                                              // buffer size
+    NULL,                                           // file
+    -1,                                             // fd
+    { NULL, 0, NULL, NULL },                        // map
+    0,                                              // received
+    0,                                              // depth
+    NULL,                                           // scanner
+    0,                                              // buffered
+    0,                                              // consumed
+    false,                                          // incremental
+    NULL,                                           // arena
+    0,                                              // arena size
+    0,                                              // arena used
+    0,                                              // peak buffer
+    0,                                              // peak arena
+    0,                                              // peak mapped
+    { 0, 0, 0, 0, 0, 0, 0 },                        // stats
+    { NULL, NULL, NULL, NULL },                     // allocator
+    NULL,                                           // latency
+    0,                                              // started
+    0                                               // started elements
 };
 
+static const char* NULL_FILE_MESSAGE = "The file cannot be NULL";
+static const char* INVALID_FD_MESSAGE = "The file descriptor is not valid";
+static const char* ARENA_FULL_MESSAGE = "Not enough room in the arena of the reader";
+static const char* NULL_VALUES_MESSAGE = "The values cannot be NULL while the capacity is greater than zero (0)";
+static const char* NULL_BUFFER_MESSAGE = "The buffer cannot be NULL while the capacity is greater than zero (0)";
+static const char* UNBALANCED_MESSAGE = "The begin and end calls for maps, arrays, strings, binary blobs, and extension types are not balanced";
+
 static void
 labpack_reader_check_decoder(labpack_reader_t* reader)
 {
     mpack_error_t result = mpack_reader_error(reader->decoder);
     if (result != mpack_ok) {
+        if (reader->status != LABPACK_STATUS_ERROR_DECODER) {
+            LABPACK_PROBE3(reader__error, reader, result, labpack_reader_offset(reader));
+        }
         reader->status = LABPACK_STATUS_ERROR_DECODER;
         reader->status_message = labpack_mpack_error_message(result);
     }
 }
 
+/**
+ * Records the peaks of the memory held by the reader. This is called after
+ * the buffer, arena, or mapped file changes instead of for every message.
+ */
+static void
+labpack_reader_track_peaks(labpack_reader_t* reader)
+{
+    if (reader->buffer_size > reader->peak_buffer) {
+        reader->peak_buffer = reader->buffer_size;
+    }
+    if (reader->arena_size > reader->peak_arena) {
+        reader->peak_arena = reader->arena_size;
+    }
+    if (reader->map.size > reader->peak_mapped) {
+        reader->peak_mapped = reader->map.size;
+    }
+}
+
+/**
+ * Tracks the nesting of begin and end calls. This is much cheaper than the
+ * read tracking of mpack, which is compiled out of performance builds, but
+ * still catches an end without a begin and a message left unfinished.
+ */
+static void
+labpack_reader_enter(labpack_reader_t* reader)
+{
+    reader->depth += 1;
+}
+
+static void
+labpack_reader_leave(labpack_reader_t* reader)
+{
+    if (reader->depth > 0) {
+        reader->depth -= 1;
+    } else if (labpack_reader_is_ok(reader)) {
+        mpack_reader_flag_error(reader->decoder, mpack_error_bug);
+        reader->status = LABPACK_STATUS_ERROR_DECODER;
+        reader->status_message = UNBALANCED_MESSAGE;
+        LABPACK_PROBE3(reader__error, reader, mpack_error_bug, labpack_reader_offset(reader));
+    }
+}
+
 static void
 labpack_reader_reset_status(labpack_reader_t* reader)
 {
     assert(reader);
+    // An error is counted when it is cleared, or when the stats are gathered,
+    // so raising one does not need to be counted at every place it occurs.
+    if (reader->status != LABPACK_STATUS_OK) {
+        reader->stats.errors += 1;
+    }
     reader->status = LABPACK_STATUS_OK;
     reader->status_message = labpack_status_string(reader->status);
 }
@@ -68,22 +161,57 @@ static void
 labpack_reader_init(labpack_reader_t* reader)
 {
     assert(reader);
-    reader->decoder = malloc(sizeof(mpack_reader_t));
+    memset(&reader->stats, 0, sizeof(reader->stats));
+    reader->status = LABPACK_STATUS_OK;
+    reader->decoder = labpack_allocate(&reader->allocator, sizeof(mpack_reader_t));
     if (reader->decoder) {
         labpack_reader_reset_status(reader);
     } else {
         reader->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
         reader->status_message = "Not enough memory available to create internal decoder";
     }
+    reader->buffer = NULL;
+    reader->buffer_size = 0;
+    reader->file = NULL;
+    reader->fd = -1;
+    reader->map.data = NULL;
+    reader->map.size = 0;
+    reader->map.handle = NULL;
+    reader->map.mapping = NULL;
+    reader->received = 0;
+    reader->depth = 0;
+    reader->scanner = NULL;
+    reader->buffered = 0;
+    reader->consumed = 0;
+    reader->incremental = false;
+    reader->arena = NULL;
+    reader->arena_size = 0;
+    reader->arena_used = 0;
+    reader->peak_buffer = 0;
+    reader->peak_arena = 0;
+    reader->peak_mapped = 0;
+    reader->latency = NULL;
+    reader->started = 0;
+    reader->started_elements = 0;
 }
 
 labpack_reader_t*
 labpack_reader_create()
 {
-    labpack_reader_t* reader = malloc(sizeof(labpack_reader_t));
+    return labpack_reader_create_with_allocator(NULL);
+}
+
+labpack_reader_t*
+labpack_reader_create_with_allocator(const labpack_allocator_t* allocator)
+{
+    if (allocator == NULL) {
+        allocator = labpack_current_allocator();
+    }
+    labpack_reader_t* reader = labpack_allocate(allocator, sizeof(labpack_reader_t));
     if (reader == NULL) {
         return &OUT_OF_MEMORY_READER;
     }
+    reader->allocator = *allocator;
     labpack_reader_init(reader);
     return reader;
 }
@@ -91,9 +219,23 @@ labpack_reader_create()
 void
 labpack_reader_destroy(labpack_reader_t* reader)
 {
-    free(reader->decoder);
+    if (reader == &OUT_OF_MEMORY_READER) {
+        return;
+    }
+    // The reader is freed with a copy, since the allocator is inside of it
+    labpack_allocator_t allocator = reader->allocator;
+    labpack_map_close(&reader->map);
+    labpack_release(&allocator, reader->decoder);
     reader->decoder = NULL;
-    free(reader);
+    labpack_release(&allocator, reader->buffer);
+    reader->buffer = NULL;
+    labpack_release(&allocator, reader->scanner);
+    reader->scanner = NULL;
+    labpack_release(&allocator, reader->arena);
+    reader->arena = NULL;
+    labpack_release(&allocator, reader->latency);
+    reader->latency = NULL;
+    labpack_release(&allocator, reader);
 }
 
 labpack_status_t
@@ -124,21 +266,746 @@ labpack_reader_is_error(labpack_reader_t* reader)
     return labpack_reader_status(reader) != LABPACK_STATUS_OK;
 }
 
+static void
+labpack_reader_start_message(labpack_reader_t* reader)
+{
+    reader->started = labpack_latency_start(reader->latency);
+    reader->started_elements = reader->stats.elements;
+}
+
+static void
+labpack_reader_stop_message(labpack_reader_t* reader)
+{
+    // Nothing is recorded for a message that was not read at all, such as
+    // between beginning and the first labpack_reader_next_message
+    if (reader->stats.elements > reader->started_elements) {
+        labpack_latency_stop(reader->latency, LABPACK_LATENCY_MESSAGE, reader->started);
+    }
+    reader->started = 0;
+}
+
 void
 labpack_reader_begin(labpack_reader_t* reader, const char* data, size_t count)
 {
     assert(reader);
+    labpack_map_close(&reader->map);
+    labpack_reader_start_message(reader);
+    reader->incremental = false;
+    reader->received = count;
+    reader->depth = 0;
     mpack_reader_init_data(reader->decoder, data, count);
     labpack_reader_reset_status(reader);
+    LABPACK_PROBE2(reader__begin, reader, count);
+}
+
+static void
+labpack_reader_skip_using_fill(mpack_reader_t* decoder, size_t count)
+{
+    // The skip callback is only called once the buffer has been consumed, so
+    // the buffer can be reused to read and drop the bytes.
+    while (count > 0 && mpack_reader_error(decoder) == mpack_ok) {
+        size_t chunk = count < decoder->size ? count : decoder->size;
+        size_t read = decoder->fill(decoder, decoder->buffer, chunk);
+        if (read == 0) {
+            mpack_reader_flag_error(decoder, mpack_error_io);
+            return;
+        }
+        count -= read;
+    }
+}
+
+static size_t
+labpack_reader_fill_stdfile(mpack_reader_t* decoder, char* buffer, size_t count)
+{
+    labpack_reader_t* reader = (labpack_reader_t*)decoder->context;
+    size_t read = fread(buffer, 1, count, reader->file);
+    reader->received += read;
+    return read;
+}
+
+static void
+labpack_reader_skip_stdfile(mpack_reader_t* decoder, size_t count)
+{
+    labpack_reader_t* reader = (labpack_reader_t*)decoder->context;
+    // The ftell function is used to test whether the stream is seekable
+    // without causing a file error, e.g. for pipes.
+    if (count <= LONG_MAX && ftell(reader->file) >= 0) {
+        if (fseek(reader->file, (long)count, SEEK_CUR) == 0) {
+            reader->received += count;
+            return;
+        }
+        if (ferror(reader->file)) {
+            mpack_reader_flag_error(decoder, mpack_error_io);
+            return;
+        }
+    }
+    labpack_reader_skip_using_fill(decoder, count);
+}
+
+static size_t
+labpack_reader_fill_fd(mpack_reader_t* decoder, char* buffer, size_t count)
+{
+    labpack_reader_t* reader = (labpack_reader_t*)decoder->context;
+#ifdef _WIN32
+    int result = 0;
+    do {
+        result = _read(reader->fd, buffer, count > INT_MAX ? INT_MAX : (unsigned int)count);
+    } while (result < 0 && errno == EINTR);
+#else
+    ssize_t result = 0;
+    do {
+        result = read(reader->fd, buffer, count);
+    } while (result < 0 && errno == EINTR);
+#endif
+    if (result <= 0) {
+        return 0;
+    }
+    reader->received += (uint64_t)result;
+    return (size_t)result;
+}
+
+static void
+labpack_reader_skip_fd(mpack_reader_t* decoder, size_t count)
+{
+    labpack_reader_t* reader = (labpack_reader_t*)decoder->context;
+#ifdef _WIN32
+    if (_lseeki64(reader->fd, (__int64)count, SEEK_CUR) >= 0) {
+        reader->received += count;
+        return;
+    }
+#else
+    if (count <= LONG_MAX && lseek(reader->fd, (off_t)count, SEEK_CUR) >= 0) {
+        reader->received += count;
+        return;
+    }
+#endif
+    // Pipes, sockets, and terminals cannot seek.
+    labpack_reader_skip_using_fill(decoder, count);
+}
+
+static void
+labpack_reader_begin_stream(labpack_reader_t* reader, size_t buffer_size, mpack_reader_fill_t fill, mpack_reader_skip_t skip)
+{
+    if (buffer_size == 0) {
+        buffer_size = MPACK_BUFFER_SIZE;
+    } else if (buffer_size < MPACK_READER_MINIMUM_BUFFER_SIZE) {
+        buffer_size = MPACK_READER_MINIMUM_BUFFER_SIZE;
+    }
+    // The buffer is kept between messages and only reallocated when a
+    // different size is requested.
+    if (reader->buffer_size != buffer_size) {
+        char* buffer = labpack_reallocate(&reader->allocator, reader->buffer, buffer_size);
+        if (!buffer) {
+            reader->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+            reader->status_message = "Not enough memory available for the stream buffer";
+            mpack_reader_init_error(reader->decoder, mpack_error_memory);
+            return;
+        }
+        if (reader->buffer) {
+            reader->stats.reallocations += 1;
+        } else {
+            reader->stats.allocations += 1;
+        }
+        LABPACK_PROBE3(reader__grow, reader, reader->buffer_size, buffer_size);
+        reader->buffer = buffer;
+        reader->buffer_size = buffer_size;
+        labpack_reader_track_peaks(reader);
+    }
+    reader->received = 0;
+    reader->depth = 0;
+    mpack_reader_init(reader->decoder, reader->buffer, reader->buffer_size, 0);
+    mpack_reader_set_context(reader->decoder, reader);
+    mpack_reader_set_fill(reader->decoder, fill);
+    mpack_reader_set_skip(reader->decoder, skip);
+    LABPACK_PROBE2(reader__begin, reader, 0);
+}
+
+void
+labpack_reader_begin_stdfile(labpack_reader_t* reader, FILE* file, size_t buffer_size)
+{
+    assert(reader);
+    labpack_map_close(&reader->map);
+    labpack_reader_start_message(reader);
+    reader->incremental = false;
+    labpack_reader_reset_status(reader);
+    if (!file) {
+        mpack_reader_init_error(reader->decoder, mpack_error_io);
+        reader->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+        reader->status_message = NULL_FILE_MESSAGE;
+        return;
+    }
+    reader->file = file;
+    reader->fd = -1;
+    labpack_reader_begin_stream(reader, buffer_size, labpack_reader_fill_stdfile, labpack_reader_skip_stdfile);
+}
+
+void
+labpack_reader_begin_fd(labpack_reader_t* reader, int fd, size_t buffer_size)
+{
+    assert(reader);
+    labpack_map_close(&reader->map);
+    labpack_reader_start_message(reader);
+    reader->incremental = false;
+    labpack_reader_reset_status(reader);
+    if (fd < 0) {
+        mpack_reader_init_error(reader->decoder, mpack_error_io);
+        reader->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+        reader->status_message = INVALID_FD_MESSAGE;
+        return;
+    }
+    reader->file = NULL;
+    reader->fd = fd;
+    labpack_reader_begin_stream(reader, buffer_size, labpack_reader_fill_fd, labpack_reader_skip_fd);
+}
+
+void
+labpack_reader_begin_file(labpack_reader_t* reader, const char* path)
+{
+    assert(reader);
+    labpack_map_close(&reader->map);
+    labpack_reader_start_message(reader);
+    reader->incremental = false;
+    labpack_reader_reset_status(reader);
+    reader->depth = 0;
+    if (!path) {
+        mpack_reader_init_error(reader->decoder, mpack_error_io);
+        reader->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+        reader->status_message = "The path cannot be NULL";
+        return;
+    }
+    if (labpack_map_open(&reader->map, path) != LABPACK_STATUS_OK) {
+        mpack_reader_init_error(reader->decoder, mpack_error_io);
+        reader->status = LABPACK_STATUS_ERROR_IO;
+        reader->status_message = "The file could not be opened and mapped into memory";
+        return;
+    }
+    reader->received = reader->map.size;
+    labpack_reader_track_peaks(reader);
+    mpack_reader_init_data(reader->decoder, reader->map.data, reader->map.size);
+    LABPACK_PROBE2(reader__begin, reader, reader->map.size);
+}
+
+/**
+ * Points the decoder at no data where the next message will start, so
+ * reading before another message is complete fails like reading past the end
+ * of a buffer.
+ */
+static void
+labpack_reader_wait_incremental(labpack_reader_t* reader)
+{
+    if (reader->buffer) {
+        mpack_reader_init_data(reader->decoder, reader->buffer + reader->consumed, 0);
+    } else {
+        mpack_reader_init_data(reader->decoder, "", 0);
+    }
+}
+
+void
+labpack_reader_begin_incremental(labpack_reader_t* reader)
+{
+    assert(reader);
+    labpack_map_close(&reader->map);
+    labpack_reader_start_message(reader);
+    labpack_reader_reset_status(reader);
+    reader->incremental = false;
+    reader->received = 0;
+    reader->depth = 0;
+    if (!reader->scanner) {
+        reader->scanner = labpack_allocate(&reader->allocator, sizeof(labpack_scanner_t));
+        if (!reader->scanner) {
+            reader->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+            reader->status_message = "Not enough memory available for incremental decoding";
+            mpack_reader_init_error(reader->decoder, mpack_error_memory);
+            return;
+        }
+        reader->stats.allocations += 1;
+    }
+    labpack_scanner_init(reader->scanner, LABPACK_MAX_DEPTH, true);
+    reader->buffered = 0;
+    reader->consumed = 0;
+    reader->incremental = true;
+    labpack_reader_wait_incremental(reader);
+    LABPACK_PROBE2(reader__begin, reader, 0);
+}
+
+void
+labpack_reader_feed(labpack_reader_t* reader, const char* data, size_t count)
+{
+    assert(reader);
+    if (labpack_reader_is_error(reader)) {
+        return;
+    }
+    if (!reader->incremental) {
+        reader->status = LABPACK_STATUS_ERROR_INVALID_ARGUMENT;
+        reader->status_message = "Data can only be fed to a reader begun for incremental decoding";
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+    if (!data) {
+        reader->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+        reader->status_message = "The data cannot be NULL while the count is greater than zero (0)";
+        return;
+    }
+    // The decoder may be part way through the current message, which is read
+    // in place, so its position is kept as offsets while the buffer moves.
+    mpack_reader_t* decoder = reader->decoder;
+    size_t data_offset = 0;
+    size_t end_offset = 0;
+    if (reader->buffer) {
+        data_offset = (size_t)(decoder->data - reader->buffer);
+        end_offset = (size_t)(decoder->end - reader->buffer);
+    }
+    if (count > reader->buffer_size - reader->buffered && data_offset > 0) {
+        // Drop the bytes that have already been read before growing, so the
+        // buffer only needs to hold the largest message plus a partial one.
+        memmove(reader->buffer, reader->buffer + data_offset, reader->buffered - data_offset);
+        reader->stats.bytes_copied += reader->buffered - data_offset;
+        reader->buffered -= data_offset;
+        reader->consumed -= data_offset;
+        reader->scanner->position -= data_offset;
+        end_offset -= data_offset;
+        data_offset = 0;
+    }
+    if (count > reader->buffer_size - reader->buffered) {
+        size_t needed = reader->buffered + count;
+        if (needed < count) {
+            reader->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+            reader->status_message = "Not enough memory available for the incremental buffer";
+            mpack_reader_flag_error(decoder, mpack_error_memory);
+            return;
+        }
+        size_t capacity = reader->buffer_size > 0 ? reader->buffer_size : MPACK_BUFFER_SIZE;
+        while (capacity < needed) {
+            capacity = capacity > SIZE_MAX / 2 ? needed : capacity * 2;
+        }
+        char* buffer = labpack_reallocate(&reader->allocator, reader->buffer, capacity);
+        if (!buffer) {
+            reader->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+            reader->status_message = "Not enough memory available for the incremental buffer";
+            mpack_reader_flag_error(decoder, mpack_error_memory);
+            return;
+        }
+        if (reader->buffer) {
+            reader->stats.reallocations += 1;
+            reader->stats.bytes_copied += reader->buffered;
+        } else {
+            reader->stats.allocations += 1;
+        }
+        LABPACK_PROBE3(reader__grow, reader, reader->buffer_size, capacity);
+        reader->buffer = buffer;
+        reader->buffer_size = capacity;
+        labpack_reader_track_peaks(reader);
+    }
+    memcpy(reader->buffer + reader->buffered, data, count);
+    reader->buffered += count;
+    reader->stats.bytes_copied += count;
+    decoder->data = reader->buffer + data_offset;
+    decoder->end = reader->buffer + end_offset;
+}
+
+/**
+ * Scans the fed data for the next complete message, resuming from where the
+ * previous scan ran out of data, and begins decoding it in place.
+ */
+static bool
+labpack_reader_next_incremental(labpack_reader_t* reader)
+{
+    // With read tracking enabled, this flags an error if the previous
+    // message was not completely read.
+    mpack_reader_destroy(reader->decoder);
+    labpack_reader_check_decoder(reader);
+    if (labpack_reader_is_error(reader)) {
+        return false;
+    }
+    labpack_scanner_t* scanner = reader->scanner;
+    switch (labpack_scanner_resume(scanner, reader->buffer, reader->buffered)) {
+        case LABPACK_SCAN_COMPLETE: {
+            size_t length = scanner->position - reader->consumed;
+            mpack_reader_init_data(reader->decoder, reader->buffer + reader->consumed, length);
+            reader->received += length;
+            reader->consumed = scanner->position;
+            return true;
+        }
+        case LABPACK_SCAN_INCOMPLETE:
+            labpack_reader_wait_incremental(reader);
+            return false;
+        default:
+            mpack_reader_init_error(reader->decoder, mpack_error_invalid);
+            reader->status = LABPACK_STATUS_ERROR_DECODER;
+            reader->status_message = labpack_mpack_error_message(mpack_error_invalid);
+            LABPACK_PROBE3(reader__error, reader, mpack_error_invalid, reader->received + reader->scanner->position - reader->consumed);
+            return false;
+    }
 }
 
 void
 labpack_reader_end(labpack_reader_t* reader)
 {
     assert(reader);
-    if (mpack_reader_destroy(reader->decoder) != mpack_ok) {
+    if (reader->depth > 0 && labpack_reader_is_ok(reader)) {
+        mpack_reader_flag_error(reader->decoder, mpack_error_bug);
+        reader->status = LABPACK_STATUS_ERROR_DECODER;
+        reader->status_message = UNBALANCED_MESSAGE;
+        LABPACK_PROBE3(reader__error, reader, mpack_error_bug, labpack_reader_offset(reader));
+    }
+    if (labpack_reader_is_ok(reader)) {
+        reader->stats.bytes += labpack_reader_offset(reader);
+    }
+    if (mpack_reader_destroy(reader->decoder) != mpack_ok && labpack_reader_is_ok(reader)) {
         reader->status = LABPACK_STATUS_ERROR_DECODER;
         reader->status_message = mpack_error_to_string(mpack_reader_error(reader->decoder));
+        LABPACK_PROBE3(reader__error, reader, mpack_reader_error(reader->decoder), labpack_reader_offset(reader));
+    }
+    labpack_map_close(&reader->map);
+    reader->incremental = false;
+    reader->arena_used = 0;
+    labpack_reader_stop_message(reader);
+    LABPACK_PROBE3(reader__end, reader, labpack_reader_offset(reader), reader->status);
+}
+
+bool
+labpack_reader_next_message(labpack_reader_t* reader)
+{
+    assert(reader);
+    reader->arena_used = 0;
+    labpack_reader_stop_message(reader);
+    labpack_reader_start_message(reader);
+    LABPACK_PROBE2(reader__next, reader, labpack_reader_offset(reader));
+    if (labpack_reader_is_error(reader)) {
+        return false;
+    }
+    if (reader->depth > 0) {
+        // The previous message left a container open, so the remaining data
+        // cannot be framed into messages.
+        mpack_reader_flag_error(reader->decoder, mpack_error_bug);
+        reader->status = LABPACK_STATUS_ERROR_DECODER;
+        reader->status_message = UNBALANCED_MESSAGE;
+        LABPACK_PROBE3(reader__error, reader, mpack_error_bug, labpack_reader_offset(reader));
+        return false;
+    }
+    if (reader->incremental) {
+        return labpack_reader_next_incremental(reader);
+    }
+    mpack_reader_t* decoder = reader->decoder;
+    // With read tracking enabled, this also flags an error if the previous
+    // message was not completely read.
+    size_t remaining = mpack_reader_remaining(decoder, NULL);
+    labpack_reader_check_decoder(reader);
+    if (remaining > 0 || labpack_reader_is_error(reader)) {
+        return remaining > 0;
+    }
+    if (!decoder->fill) {
+        return false;
+    }
+    // The buffer is empty, so a stream is refilled to find out if another
+    // message follows. Reaching the end of the stream here is not an error.
+    size_t read = decoder->fill(decoder, decoder->buffer, decoder->size);
+    decoder->data = decoder->buffer;
+    decoder->end = decoder->buffer + read;
+    labpack_reader_check_decoder(reader);
+    return read > 0 && labpack_reader_is_ok(reader);
+}
+
+uint64_t
+labpack_reader_offset(labpack_reader_t* reader)
+{
+    assert(reader);
+    return reader->received - (uint64_t)(reader->decoder->end - reader->decoder->data);
+}
+
+void
+labpack_reader_stats(labpack_reader_t* reader, labpack_stats_t* stats)
+{
+    assert(reader);
+    assert(stats);
+    *stats = reader->stats;
+    if (labpack_reader_is_error(reader)) {
+        stats->errors += 1;
+    }
+}
+
+void
+labpack_reader_footprint(labpack_reader_t* reader, labpack_footprint_t* footprint)
+{
+    assert(reader);
+    assert(footprint);
+    footprint->buffer = reader->buffer_size;
+    footprint->peak_buffer = reader->peak_buffer;
+    footprint->arena = reader->arena_size;
+    footprint->peak_arena = reader->peak_arena;
+    footprint->mapped = reader->map.size;
+    footprint->peak_mapped = reader->peak_mapped;
+}
+
+void
+labpack_reader_set_latency(labpack_reader_t* reader, bool enabled)
+{
+    assert(reader);
+    if (labpack_reader_is_ok(reader)) {
+        reader->latency = labpack_latency_set(&reader->allocator, reader->latency, enabled);
+        reader->started = 0;
+        if (enabled && !reader->latency) {
+            reader->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+            reader->status_message = "Not enough memory available for the latency histograms";
+        }
+    }
+}
+
+uint64_t
+labpack_reader_latency_histogram(labpack_reader_t* reader, labpack_latency_t latency, uint64_t* counts)
+{
+    assert(reader);
+    return labpack_latency_histogram(reader->latency, latency, counts);
+}
+
+uint64_t
+labpack_reader_latency_percentile(labpack_reader_t* reader, labpack_latency_t latency, double percentile)
+{
+    assert(reader);
+    return labpack_latency_percentile(reader->latency, latency, percentile);
+}
+
+void
+labpack_reader_peek(labpack_reader_t* reader, labpack_type_t* type, uint32_t* count_or_length)
+{
+    assert(reader);
+    labpack_type_t peeked_type = LABPACK_TYPE_NIL;
+    uint32_t peeked_count = 0;
+    if (labpack_reader_is_ok(reader)) {
+        mpack_tag_t tag = mpack_peek_tag(reader->decoder);
+        labpack_reader_check_decoder(reader);
+        if (labpack_reader_is_ok(reader)) {
+            peeked_type = labpack_from_mpack_type(tag.type);
+            switch (tag.type) {
+                case mpack_type_str:
+                case mpack_type_bin:
+                    peeked_count = tag.v.l;
+                    break;
+                case mpack_type_ext:
+                    peeked_count = tag.v.ext.length;
+                    break;
+                case mpack_type_array:
+                case mpack_type_map:
+                    peeked_count = tag.v.n;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    if (type) {
+        *type = peeked_type;
+    }
+    if (count_or_length) {
+        *count_or_length = peeked_count;
+    }
+}
+
+void
+labpack_reader_skip(labpack_reader_t* reader, uint32_t count)
+{
+    assert(reader);
+    for (uint32_t i = 0; i < count && labpack_reader_is_ok(reader); i++) {
+        mpack_discard(reader->decoder);
+        reader->stats.elements += 1;
+        labpack_reader_check_decoder(reader);
+    }
+}
+
+/**
+ * Reads a str key and finds it in the key set without any status checks, so
+ * it can be shared by the single key and record readers.
+ */
+static int32_t
+labpack_reader_find_key(labpack_reader_t* reader, const labpack_keyset_t* keyset)
+{
+    int32_t index = -1;
+    uint32_t length = mpack_expect_str(reader->decoder);
+    if (mpack_reader_error(reader->decoder) == mpack_ok) {
+        if (length > keyset->max_length) {
+            // Longer than every name, so it cannot match
+            mpack_skip_bytes(reader->decoder, length);
+        } else {
+            const char* key = mpack_read_bytes_inplace(reader->decoder, length);
+            if (mpack_reader_error(reader->decoder) == mpack_ok) {
+                index = labpack_keyset_find(keyset, key, length);
+            }
+        }
+        mpack_done_str(reader->decoder);
+    }
+    return index;
+}
+
+int32_t
+labpack_reader_expect_key(labpack_reader_t* reader, labpack_keyset_t* keyset)
+{
+    assert(reader);
+    assert(keyset);
+    int32_t index = -1;
+    if (labpack_reader_is_ok(reader)) {
+        if (labpack_keyset_is_error(keyset)) {
+            reader->status = keyset->status;
+            reader->status_message = keyset->status_message;
+            return index;
+        }
+        index = labpack_reader_find_key(reader, keyset);
+        reader->stats.elements += 1;
+        labpack_reader_check_decoder(reader);
+    }
+    return index;
+}
+
+static void
+labpack_reader_read_field(labpack_reader_t* reader, const labpack_field_t* field, char* out)
+{
+    mpack_reader_t* decoder = reader->decoder;
+    // The fields are copied with memcpy because LabVIEW clusters are packed
+    // on some platforms, so the offsets may not be aligned.
+    switch (field->type) {
+        case LABPACK_TYPE_BOOL: {
+            bool value = mpack_expect_bool(decoder);
+            memcpy(out, &value, sizeof(value));
+            break;
+        }
+        case LABPACK_TYPE_INT: {
+            switch (field->size) {
+                case 1: { int8_t value = mpack_expect_i8(decoder); memcpy(out, &value, sizeof(value)); break; }
+                case 2: { int16_t value = mpack_expect_i16(decoder); memcpy(out, &value, sizeof(value)); break; }
+                case 4: { int32_t value = mpack_expect_i32(decoder); memcpy(out, &value, sizeof(value)); break; }
+                default: { int64_t value = mpack_expect_i64(decoder); memcpy(out, &value, sizeof(value)); break; }
+            }
+            break;
+        }
+        case LABPACK_TYPE_UINT: {
+            switch (field->size) {
+                case 1: { uint8_t value = mpack_expect_u8(decoder); memcpy(out, &value, sizeof(value)); break; }
+                case 2: { uint16_t value = mpack_expect_u16(decoder); memcpy(out, &value, sizeof(value)); break; }
+                case 4: { uint32_t value = mpack_expect_u32(decoder); memcpy(out, &value, sizeof(value)); break; }
+                default: { uint64_t value = mpack_expect_u64(decoder); memcpy(out, &value, sizeof(value)); break; }
+            }
+            break;
+        }
+        case LABPACK_TYPE_FLOAT: {
+            float value = mpack_expect_float(decoder);
+            memcpy(out, &value, sizeof(value));
+            break;
+        }
+        case LABPACK_TYPE_DOUBLE: {
+            double value = mpack_expect_double(decoder);
+            memcpy(out, &value, sizeof(value));
+            break;
+        }
+        case LABPACK_TYPE_STR: {
+            uint32_t length = mpack_expect_str(decoder);
+            if (mpack_reader_error(decoder) != mpack_ok) {
+                break;
+            }
+            if (length >= field->size) {
+                // No room for the NUL terminator
+                mpack_reader_flag_error(decoder, mpack_error_too_big);
+                break;
+            }
+            mpack_read_bytes(decoder, out, length);
+            reader->stats.bytes_copied += length;
+            if (mpack_reader_error(decoder) == mpack_ok) {
+                out[length] = '\0';
+            }
+            mpack_done_str(decoder);
+            break;
+        }
+        default: assert(false);
+    }
+}
+
+void
+labpack_read_record(labpack_reader_t* reader, labpack_schema_t* schema, void* out)
+{
+    assert(reader);
+    assert(schema);
+    if (labpack_reader_is_ok(reader)) {
+        if (labpack_schema_is_error(schema)) {
+            reader->status = schema->status;
+            reader->status_message = schema->status_message;
+            return;
+        }
+        if (out == NULL) {
+            reader->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+            reader->status_message = "The record cannot be NULL";
+            return;
+        }
+        uint64_t start = labpack_latency_start(reader->latency);
+        uint32_t count = mpack_expect_map(reader->decoder);
+        reader->stats.elements += 1 + (uint64_t)count * 2;
+        reader->stats.containers += 1;
+        for (uint32_t i = 0; i < count && mpack_reader_error(reader->decoder) == mpack_ok; i++) {
+            int32_t index = labpack_reader_find_key(reader, schema->keyset);
+            if (index < 0) {
+                mpack_discard(reader->decoder);
+            } else {
+                const labpack_field_t* field = &schema->fields[index];
+                labpack_reader_read_field(reader, field, (char*)out + field->offset);
+            }
+        }
+        mpack_done_map(reader->decoder);
+        labpack_latency_stop(reader->latency, LABPACK_LATENCY_BULK, start);
+        labpack_reader_check_decoder(reader);
+    }
+}
+
+/**
+ * Places a reader into an error state without any data, so it can be ended
+ * like any other reader.
+ */
+static void
+labpack_reader_begin_error(labpack_reader_t* reader, labpack_status_t status, const char* message)
+{
+    labpack_map_close(&reader->map);
+    labpack_reader_start_message(reader);
+    labpack_reader_reset_status(reader);
+    reader->incremental = false;
+    reader->received = 0;
+    reader->depth = 0;
+    mpack_reader_init_error(reader->decoder, mpack_error_data);
+    reader->status = status;
+    reader->status_message = message;
+}
+
+void
+labpack_reader_subreader(labpack_reader_t* reader, labpack_reader_t* child)
+{
+    assert(reader);
+    assert(child);
+    assert(reader != child);
+    if (child->decoder == NULL) {
+        // The child could not be created, so the element is left in place
+        // rather than silently skipped.
+        if (labpack_reader_is_ok(reader)) {
+            reader->status = child->status;
+            reader->status_message = child->status_message;
+        }
+        return;
+    }
+    if (labpack_reader_is_error(reader)) {
+        labpack_reader_begin_error(child, reader->status, reader->status_message);
+        return;
+    }
+    mpack_reader_t* decoder = reader->decoder;
+    if (decoder->fill) {
+        reader->status = LABPACK_STATUS_ERROR_INVALID_ARGUMENT;
+        reader->status_message = "Sub-readers are only available for data in memory";
+        labpack_reader_begin_error(child, reader->status, reader->status_message);
+        return;
+    }
+    reader->stats.elements += 1;
+    const char* start = decoder->data;
+    mpack_discard(decoder);
+    labpack_reader_check_decoder(reader);
+    if (labpack_reader_is_ok(reader)) {
+        labpack_reader_begin(child, start, (size_t)(decoder->data - start));
+    } else {
+        labpack_reader_begin_error(child, reader->status, reader->status_message);
     }
 }
 
@@ -149,6 +1016,7 @@ labpack_read_u8(labpack_reader_t* reader)
     uint8_t value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_u8(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -161,6 +1029,7 @@ labpack_read_u16(labpack_reader_t* reader)
     uint16_t value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_u16(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -173,6 +1042,7 @@ labpack_read_u32(labpack_reader_t* reader)
     uint32_t value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_u32(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -185,6 +1055,7 @@ labpack_read_u64(labpack_reader_t* reader)
     uint64_t value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_u64(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -197,6 +1068,7 @@ labpack_read_uint(labpack_reader_t* reader)
     unsigned int value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_uint(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -209,6 +1081,7 @@ labpack_read_i8(labpack_reader_t* reader)
     int8_t value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_i8(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -221,6 +1094,7 @@ labpack_read_i16(labpack_reader_t* reader)
     int16_t value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_i16(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -233,6 +1107,7 @@ labpack_read_i32(labpack_reader_t* reader)
     int32_t value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_i32(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -245,6 +1120,7 @@ labpack_read_i64(labpack_reader_t* reader)
     int64_t value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_i64(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -257,6 +1133,7 @@ labpack_read_int(labpack_reader_t* reader)
     int value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_int(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -269,6 +1146,7 @@ labpack_read_float(labpack_reader_t* reader)
     float value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_float(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -281,6 +1159,7 @@ labpack_read_double(labpack_reader_t* reader)
     double value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_double(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -293,6 +1172,7 @@ labpack_read_float_strict(labpack_reader_t* reader)
     float value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_float_strict(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -305,6 +1185,7 @@ labpack_read_double_strict(labpack_reader_t* reader)
     double value = 0;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_double_strict(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -316,6 +1197,7 @@ labpack_read_nil(labpack_reader_t* reader)
     assert(reader);
     if (labpack_reader_is_ok(reader)) {
         mpack_expect_nil(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
 }
@@ -327,6 +1209,7 @@ labpack_read_bool(labpack_reader_t* reader)
     bool value = false;
     if (labpack_reader_is_ok(reader)) {
         value = mpack_expect_bool(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
     return value;
@@ -338,6 +1221,7 @@ labpack_read_true(labpack_reader_t* reader)
     assert(reader);
     if (labpack_reader_is_ok(reader)) {
         mpack_expect_true(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
 }
@@ -348,8 +1232,347 @@ labpack_read_false(labpack_reader_t* reader)
     assert(reader);
     if (labpack_reader_is_ok(reader)) {
         mpack_expect_false(reader->decoder);
+        reader->stats.elements += 1;
+        labpack_reader_check_decoder(reader);
+    }
+}
+
+static void
+labpack_reader_store_bool(bool* values, uint8_t* bits, uint32_t index, bool value)
+{
+    if (values) {
+        values[index] = value;
+    } else {
+        bits[index >> 3] = (uint8_t)((bits[index >> 3] & ~(1u << (index & 7))) | ((unsigned)value << (index & 7)));
+    }
+}
+
+/**
+ * Reads an array of booleans into either the values or the bits.
+ */
+static uint32_t
+labpack_reader_read_bools(labpack_reader_t* reader, bool* values, uint8_t* bits, uint32_t capacity)
+{
+    mpack_reader_t* decoder = reader->decoder;
+    uint32_t count = mpack_expect_array(decoder);
+    if (mpack_reader_error(decoder) != mpack_ok) {
+        return 0;
+    }
+    if (count > capacity) {
+        mpack_reader_flag_error(decoder, mpack_error_too_big);
+        return 0;
+    }
+    uint32_t i = 0;
+#if MPACK_READ_TRACKING
+    for (; i < count && mpack_reader_error(decoder) == mpack_ok; i++) {
+        labpack_reader_store_bool(values, bits, i, mpack_expect_bool(decoder));
+    }
+#else
+    // Each boolean is a single byte, so the elements are converted directly
+    // from the buffer without going through mpack for each one.
+    while (i < count && mpack_reader_error(decoder) == mpack_ok) {
+        size_t available = (size_t)(decoder->end - decoder->data);
+        if (available == 0) {
+            // Reading one element refills the buffer from a stream
+            labpack_reader_store_bool(values, bits, i, mpack_expect_bool(decoder));
+            i++;
+            continue;
+        }
+        size_t chunk = count - i < available ? count - i : available;
+        size_t converted = values ? labpack_bool_decode(decoder->data, chunk, values + i) : labpack_bool_decode_bits(decoder->data, chunk, bits, i);
+        decoder->data += converted;
+        i += (uint32_t)converted;
+        if (converted < chunk) {
+            mpack_reader_flag_error(decoder, mpack_error_type);
+        }
+    }
+#endif
+    mpack_done_array(decoder);
+    if (mpack_reader_error(decoder) != mpack_ok) {
+        return 0;
+    }
+    if (bits && (count & 7) != 0) {
+        bits[count >> 3] &= (uint8_t)((1u << (count & 7)) - 1);
+    }
+    return count;
+}
+
+uint32_t
+labpack_read_bool_array(labpack_reader_t* reader, bool* values, uint32_t capacity)
+{
+    assert(reader);
+    uint32_t count = 0;
+    if (labpack_reader_is_ok(reader)) {
+        if (!values && capacity > 0) {
+            reader->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+            reader->status_message = NULL_VALUES_MESSAGE;
+            return count;
+        }
+        uint64_t start = labpack_latency_start(reader->latency);
+        count = labpack_reader_read_bools(reader, values, NULL, capacity);
+        labpack_latency_stop(reader->latency, LABPACK_LATENCY_BULK, start);
+        reader->stats.elements += 1 + (uint64_t)count;
+        reader->stats.containers += 1;
+        labpack_reader_check_decoder(reader);
+    }
+    return count;
+}
+
+uint32_t
+labpack_read_bool_bitset(labpack_reader_t* reader, uint8_t* bits, uint32_t capacity)
+{
+    assert(reader);
+    uint32_t count = 0;
+    if (labpack_reader_is_ok(reader)) {
+        if (!bits && capacity > 0) {
+            reader->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+            reader->status_message = NULL_VALUES_MESSAGE;
+            return count;
+        }
+        uint64_t start = labpack_latency_start(reader->latency);
+        count = labpack_reader_read_bools(reader, NULL, bits, capacity);
+        labpack_latency_stop(reader->latency, LABPACK_LATENCY_BULK, start);
+        reader->stats.elements += 1 + (uint64_t)count;
+        reader->stats.containers += 1;
         labpack_reader_check_decoder(reader);
     }
+    return count;
+}
+
+/**
+ * LabVIEW aligns the elements of an array after the 32-bit dimension size to
+ * their natural alignment, except for 32-bit Windows where its data is
+ * packed.
+ */
+static size_t
+labpack_lv_array_offset(size_t element_size)
+{
+#if defined(_WIN32) && !defined(_WIN64)
+    (void)element_size;
+    return sizeof(int32_t);
+#else
+    return element_size > sizeof(int32_t) ? element_size : sizeof(int32_t);
+#endif
+}
+
+size_t
+labpack_lv_array_size(size_t element_size, uint32_t count)
+{
+    return labpack_lv_array_offset(element_size) + (size_t)count * element_size;
+}
+
+#if !MPACK_READ_TRACKING
+/**
+ * Converts an element directly from the buffer if it is a positive fixint
+ * for an integer type or the exact encoding of a float or double, which
+ * covers most numeric arrays. Returns false if the element must be read
+ * through mpack.
+ */
+static bool
+labpack_reader_convert_element(mpack_reader_t* decoder, const labpack_field_t* element, char* out)
+{
+    size_t available = (size_t)(decoder->end - decoder->data);
+    if (available == 0) {
+        return false;
+    }
+    uint8_t tag = (uint8_t)decoder->data[0];
+    switch (element->type) {
+        case LABPACK_TYPE_INT:
+        case LABPACK_TYPE_UINT:
+            if (tag > 0x7f) {
+                return false;
+            }
+            switch (element->size) {
+                case 1: { uint8_t value = tag; memcpy(out, &value, sizeof(value)); break; }
+                case 2: { uint16_t value = tag; memcpy(out, &value, sizeof(value)); break; }
+                case 4: { uint32_t value = tag; memcpy(out, &value, sizeof(value)); break; }
+                default: { uint64_t value = tag; memcpy(out, &value, sizeof(value)); break; }
+            }
+            decoder->data += 1;
+            return true;
+        case LABPACK_TYPE_FLOAT:
+            if (tag != 0xca || available < 5) {
+                return false;
+            }
+            {
+                float value = mpack_load_float(decoder->data + 1);
+                memcpy(out, &value, sizeof(value));
+            }
+            decoder->data += 5;
+            return true;
+        case LABPACK_TYPE_DOUBLE:
+            if (tag != 0xcb || available < 9) {
+                return false;
+            }
+            {
+                double value = mpack_load_double(decoder->data + 1);
+                memcpy(out, &value, sizeof(value));
+            }
+            decoder->data += 9;
+            return true;
+        default:
+            return false;
+    }
+}
+#endif
+
+/**
+ * Reads an array or a packed extension type into the memory layout of a
+ * LabVIEW 1D array of the element type.
+ */
+static uint32_t
+labpack_reader_decode_lv_array(labpack_reader_t* reader, labpack_type_t type, size_t size, char* out, size_t capacity)
+{
+    uint32_t count = 0;
+    if (labpack_reader_is_error(reader)) {
+        return count;
+    }
+    if (!out && capacity > 0) {
+        reader->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+        reader->status_message = NULL_BUFFER_MESSAGE;
+        return count;
+    }
+    mpack_reader_t* decoder = reader->decoder;
+    size_t offset = labpack_lv_array_offset(size);
+    mpack_tag_t tag = mpack_read_tag(decoder);
+    if (mpack_reader_error(decoder) != mpack_ok) {
+        labpack_reader_check_decoder(reader);
+        return count;
+    }
+    switch (tag.type) {
+        case mpack_type_array:
+            count = tag.v.n;
+            break;
+        case mpack_type_ext:
+            // The payload is the elements in big-endian byte order
+            if (tag.v.ext.length % size != 0) {
+                mpack_reader_flag_error(decoder, mpack_error_type);
+            }
+            count = (uint32_t)(tag.v.ext.length / size);
+            break;
+        default:
+            mpack_reader_flag_error(decoder, mpack_error_type);
+    }
+    if (mpack_reader_error(decoder) == mpack_ok && (count > INT32_MAX || capacity < offset || (capacity - offset) / size < count)) {
+        mpack_reader_flag_error(decoder, mpack_error_too_big);
+    }
+    if (mpack_reader_error(decoder) != mpack_ok) {
+        labpack_reader_check_decoder(reader);
+        return 0;
+    }
+    char* elements = out + offset;
+    if (tag.type == mpack_type_ext) {
+        // The payload is copied straight into place and swapped there
+        mpack_read_bytes(decoder, elements, tag.v.ext.length);
+        reader->stats.elements += 1;
+        reader->stats.bytes_copied += tag.v.ext.length;
+        mpack_done_ext(decoder);
+        if (mpack_reader_error(decoder) == mpack_ok) {
+            labpack_simd_byteswap(elements, count, size);
+        }
+    } else {
+        const labpack_field_t element = { NULL, type, 0, size };
+        reader->stats.elements += 1 + (uint64_t)count;
+        reader->stats.containers += 1;
+        for (uint32_t i = 0; i < count && mpack_reader_error(decoder) == mpack_ok; i++) {
+#if !MPACK_READ_TRACKING
+            if (labpack_reader_convert_element(decoder, &element, elements)) {
+                elements += size;
+                continue;
+            }
+#endif
+            labpack_reader_read_field(reader, &element, elements);
+            elements += size;
+        }
+        mpack_done_array(decoder);
+    }
+    labpack_reader_check_decoder(reader);
+    if (labpack_reader_is_error(reader)) {
+        return 0;
+    }
+    // The dimension size is in native byte order like the elements
+    int32_t dimension = (int32_t)count;
+    memcpy(out, &dimension, sizeof(dimension));
+    return count;
+}
+
+static uint32_t
+labpack_reader_read_lv_array(labpack_reader_t* reader, labpack_type_t type, size_t size, char* out, size_t capacity)
+{
+    uint64_t start = labpack_latency_start(reader->latency);
+    uint32_t count = labpack_reader_decode_lv_array(reader, type, size, out, capacity);
+    labpack_latency_stop(reader->latency, LABPACK_LATENCY_BULK, start);
+    return count;
+}
+
+uint32_t
+labpack_read_lv_array_i8(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_INT, sizeof(int8_t), out, capacity);
+}
+
+uint32_t
+labpack_read_lv_array_i16(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_INT, sizeof(int16_t), out, capacity);
+}
+
+uint32_t
+labpack_read_lv_array_i32(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_INT, sizeof(int32_t), out, capacity);
+}
+
+uint32_t
+labpack_read_lv_array_i64(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_INT, sizeof(int64_t), out, capacity);
+}
+
+uint32_t
+labpack_read_lv_array_u8(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_UINT, sizeof(uint8_t), out, capacity);
+}
+
+uint32_t
+labpack_read_lv_array_u16(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_UINT, sizeof(uint16_t), out, capacity);
+}
+
+uint32_t
+labpack_read_lv_array_u32(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_UINT, sizeof(uint32_t), out, capacity);
+}
+
+uint32_t
+labpack_read_lv_array_u64(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_UINT, sizeof(uint64_t), out, capacity);
+}
+
+uint32_t
+labpack_read_lv_array_float(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_FLOAT, sizeof(float), out, capacity);
+}
+
+uint32_t
+labpack_read_lv_array_double(labpack_reader_t* reader, char* out, size_t capacity)
+{
+    assert(reader);
+    return labpack_reader_read_lv_array(reader, LABPACK_TYPE_DOUBLE, sizeof(double), out, capacity);
 }
 
 uint32_t
@@ -359,7 +1582,13 @@ labpack_reader_begin_map(labpack_reader_t* reader)
     uint32_t count = 0;
     if (labpack_reader_is_ok(reader)) {
         count = mpack_expect_map(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
+        if (labpack_reader_is_ok(reader)) {
+            labpack_reader_enter(reader);
+            reader->stats.containers += 1;
+            LABPACK_PROBE3(reader__container__begin, reader, LABPACK_TYPE_MAP, count);
+        }
     }
     return count;
 }
@@ -371,7 +1600,13 @@ labpack_reader_begin_map_or_nil(labpack_reader_t* reader, uint32_t* count)
     bool is_map = false;
     if (labpack_reader_is_ok(reader)) {
         is_map = mpack_expect_map_or_nil(reader->decoder, count);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
+        if (is_map && labpack_reader_is_ok(reader)) {
+            labpack_reader_enter(reader);
+            reader->stats.containers += 1;
+            LABPACK_PROBE3(reader__container__begin, reader, LABPACK_TYPE_MAP, *count);
+        }
     }
     return is_map;
 }
@@ -380,8 +1615,10 @@ void
 labpack_reader_end_map(labpack_reader_t* reader)
 {
     assert(reader);
+    labpack_reader_leave(reader);
     mpack_done_map(reader->decoder);
     labpack_reader_check_decoder(reader);
+    LABPACK_PROBE2(reader__container__end, reader, LABPACK_TYPE_MAP);
 }
 
 uint32_t
@@ -391,7 +1628,13 @@ labpack_reader_begin_array(labpack_reader_t* reader)
     uint32_t count = 0;
     if (labpack_reader_is_ok(reader)) {
         count = mpack_expect_array(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
+        if (labpack_reader_is_ok(reader)) {
+            labpack_reader_enter(reader);
+            reader->stats.containers += 1;
+            LABPACK_PROBE3(reader__container__begin, reader, LABPACK_TYPE_ARRAY, count);
+        }
     }
     return count;
 }
@@ -403,7 +1646,13 @@ labpack_reader_begin_array_or_nil(labpack_reader_t* reader, uint32_t* count)
     bool is_array = false;
     if (labpack_reader_is_ok(reader)) {
         is_array = mpack_expect_array_or_nil(reader->decoder, count);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
+        if (is_array && labpack_reader_is_ok(reader)) {
+            labpack_reader_enter(reader);
+            reader->stats.containers += 1;
+            LABPACK_PROBE3(reader__container__begin, reader, LABPACK_TYPE_ARRAY, *count);
+        }
     }
     return is_array;
 }
@@ -412,8 +1661,10 @@ void
 labpack_reader_end_array(labpack_reader_t* reader)
 {
     assert(reader);
+    labpack_reader_leave(reader);
     mpack_done_array(reader->decoder);
     labpack_reader_check_decoder(reader);
+    LABPACK_PROBE2(reader__container__end, reader, LABPACK_TYPE_ARRAY);
 }
 
 uint32_t
@@ -423,7 +1674,11 @@ labpack_reader_begin_str(labpack_reader_t* reader)
     uint32_t length = 0;
     if (labpack_reader_is_ok(reader)) {
         length = mpack_expect_str(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
+        if (labpack_reader_is_ok(reader)) {
+            labpack_reader_enter(reader);
+        }
     }
     return length;
 }
@@ -432,6 +1687,7 @@ void
 labpack_reader_end_str(labpack_reader_t* reader)
 {
     assert(reader);
+    labpack_reader_leave(reader);
     if (labpack_reader_is_ok(reader)) {
         mpack_done_str(reader->decoder);
         labpack_reader_check_decoder(reader);
@@ -445,7 +1701,11 @@ labpack_reader_begin_bin(labpack_reader_t* reader)
     uint32_t count = 0;
     if (labpack_reader_is_ok(reader)) {
         count = mpack_expect_bin(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
+        if (labpack_reader_is_ok(reader)) {
+            labpack_reader_enter(reader);
+        }
     }
     return count;
 }
@@ -454,6 +1714,7 @@ void
 labpack_reader_end_bin(labpack_reader_t* reader)
 {
     assert(reader);
+    labpack_reader_leave(reader);
     if (labpack_reader_is_ok(reader)) {
         mpack_done_bin(reader->decoder);
         labpack_reader_check_decoder(reader);
@@ -467,7 +1728,11 @@ labpack_reader_begin_ext(labpack_reader_t* reader, int8_t* type)
     uint32_t count = 0;
     if (labpack_reader_is_ok(reader)) {
         count = mpack_expect_ext(reader->decoder, type);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
+        if (labpack_reader_is_ok(reader)) {
+            labpack_reader_enter(reader);
+        }
     }
     return count;
 }
@@ -476,6 +1741,7 @@ void
 labpack_reader_end_ext(labpack_reader_t* reader)
 {
     assert(reader);
+    labpack_reader_leave(reader);
     if (labpack_reader_is_ok(reader)) {
         mpack_done_ext(reader->decoder);
         labpack_reader_check_decoder(reader);
@@ -488,7 +1754,209 @@ labpack_read_bytes(labpack_reader_t* reader, char* data, size_t count)
     assert(reader);
     if (labpack_reader_is_ok(reader)) {
         mpack_read_bytes(reader->decoder, data, count);
+        reader->stats.bytes_copied += count;
+        labpack_reader_check_decoder(reader);
+    }
+}
+
+/**
+ * Copies the bytes of a str, bin, or ext after its header has been read, or
+ * flags an error without reading them if they do not fit.
+ */
+static void
+labpack_reader_read_into(labpack_reader_t* reader, char* buffer, uint32_t capacity, uint32_t count, uint32_t* length)
+{
+    if (length) {
+        *length = count;
+    }
+    if (mpack_reader_error(reader->decoder) != mpack_ok) {
+        return;
+    }
+    if (count > capacity) {
+        mpack_reader_flag_error(reader->decoder, mpack_error_too_big);
+        return;
+    }
+    if (count > 0) {
+        mpack_read_bytes(reader->decoder, buffer, count);
+        reader->stats.bytes_copied += count;
+    }
+}
+
+static bool
+labpack_reader_check_buffer(labpack_reader_t* reader, char* buffer, uint32_t capacity, uint32_t* length)
+{
+    if (length) {
+        *length = 0;
+    }
+    if (!buffer && capacity > 0) {
+        reader->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+        reader->status_message = NULL_BUFFER_MESSAGE;
+        return false;
+    }
+    return true;
+}
+
+void
+labpack_read_str_into(labpack_reader_t* reader, char* buffer, uint32_t capacity, uint32_t* length)
+{
+    assert(reader);
+    if (labpack_reader_is_ok(reader) && labpack_reader_check_buffer(reader, buffer, capacity, length)) {
+        uint32_t count = mpack_expect_str(reader->decoder);
+        labpack_reader_read_into(reader, buffer, capacity, count, length);
+        mpack_done_str(reader->decoder);
+        reader->stats.elements += 1;
+        labpack_reader_check_decoder(reader);
+    }
+}
+
+void
+labpack_read_bin_into(labpack_reader_t* reader, char* buffer, uint32_t capacity, uint32_t* length)
+{
+    assert(reader);
+    if (labpack_reader_is_ok(reader) && labpack_reader_check_buffer(reader, buffer, capacity, length)) {
+        uint32_t count = mpack_expect_bin(reader->decoder);
+        labpack_reader_read_into(reader, buffer, capacity, count, length);
+        mpack_done_bin(reader->decoder);
+        reader->stats.elements += 1;
         labpack_reader_check_decoder(reader);
     }
 }
 
+void
+labpack_read_ext_into(labpack_reader_t* reader, int8_t* type, char* buffer, uint32_t capacity, uint32_t* length)
+{
+    assert(reader);
+    assert(type);
+    if (labpack_reader_is_ok(reader) && labpack_reader_check_buffer(reader, buffer, capacity, length)) {
+        uint32_t count = mpack_expect_ext(reader->decoder, type);
+        labpack_reader_read_into(reader, buffer, capacity, count, length);
+        mpack_done_ext(reader->decoder);
+        reader->stats.elements += 1;
+        labpack_reader_check_decoder(reader);
+    }
+}
+
+void
+labpack_reader_set_arena(labpack_reader_t* reader, size_t size)
+{
+    assert(reader);
+    if (labpack_reader_is_ok(reader)) {
+        reader->arena_used = 0;
+        if (size == reader->arena_size) {
+            return;
+        }
+        labpack_release(&reader->allocator, reader->arena);
+        reader->arena = NULL;
+        reader->arena_size = 0;
+        if (size > 0) {
+            reader->arena = labpack_allocate(&reader->allocator, size);
+            if (!reader->arena) {
+                reader->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+                reader->status_message = "Not enough memory available for the arena";
+                return;
+            }
+            reader->arena_size = size;
+            reader->stats.allocations += 1;
+            labpack_reader_track_peaks(reader);
+        }
+    }
+}
+
+/**
+ * Reads the bytes of a str, bin, or ext into the next free bytes of the
+ * arena, followed by a NUL terminator if requested. Flags a memory error
+ * without reading the bytes if they do not fit.
+ */
+static char*
+labpack_reader_read_arena(labpack_reader_t* reader, uint32_t count, bool terminate, uint32_t* length)
+{
+    if (length) {
+        *length = 0;
+    }
+    if (mpack_reader_error(reader->decoder) != mpack_ok) {
+        return NULL;
+    }
+    size_t needed = (size_t)count + (terminate ? 1 : 0);
+    if (!reader->arena || needed > reader->arena_size - reader->arena_used) {
+        mpack_reader_flag_error(reader->decoder, mpack_error_memory);
+        return NULL;
+    }
+    char* data = reader->arena + reader->arena_used;
+    if (count > 0) {
+        mpack_read_bytes(reader->decoder, data, count);
+        if (mpack_reader_error(reader->decoder) != mpack_ok) {
+            return NULL;
+        }
+        reader->stats.bytes_copied += count;
+    }
+    if (terminate) {
+        data[count] = '\0';
+    }
+    reader->arena_used += needed;
+    if (length) {
+        *length = count;
+    }
+    return data;
+}
+
+/**
+ * Same as checking the decoder, but a memory error, which can only come from
+ * a full arena, is reported as running out of memory.
+ */
+static void
+labpack_reader_check_arena(labpack_reader_t* reader)
+{
+    if (mpack_reader_error(reader->decoder) == mpack_error_memory) {
+        reader->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+        reader->status_message = ARENA_FULL_MESSAGE;
+    } else {
+        labpack_reader_check_decoder(reader);
+    }
+}
+
+const char*
+labpack_read_str_arena(labpack_reader_t* reader, uint32_t* length)
+{
+    assert(reader);
+    const char* data = NULL;
+    if (labpack_reader_is_ok(reader)) {
+        uint32_t count = mpack_expect_str(reader->decoder);
+        data = labpack_reader_read_arena(reader, count, true, length);
+        mpack_done_str(reader->decoder);
+        reader->stats.elements += 1;
+        labpack_reader_check_arena(reader);
+    }
+    return labpack_reader_is_ok(reader) ? data : NULL;
+}
+
+const char*
+labpack_read_bin_arena(labpack_reader_t* reader, uint32_t* length)
+{
+    assert(reader);
+    const char* data = NULL;
+    if (labpack_reader_is_ok(reader)) {
+        uint32_t count = mpack_expect_bin(reader->decoder);
+        data = labpack_reader_read_arena(reader, count, false, length);
+        mpack_done_bin(reader->decoder);
+        reader->stats.elements += 1;
+        labpack_reader_check_arena(reader);
+    }
+    return labpack_reader_is_ok(reader) ? data : NULL;
+}
+
+const char*
+labpack_read_ext_arena(labpack_reader_t* reader, int8_t* type, uint32_t* length)
+{
+    assert(reader);
+    assert(type);
+    const char* data = NULL;
+    if (labpack_reader_is_ok(reader)) {
+        uint32_t count = mpack_expect_ext(reader->decoder, type);
+        data = labpack_reader_read_arena(reader, count, false, length);
+        mpack_done_ext(reader->decoder);
+        reader->stats.elements += 1;
+        labpack_reader_check_arena(reader);
+    }
+    return labpack_reader_is_ok(reader) ? data : NULL;
+}
+
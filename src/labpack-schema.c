@@ -0,0 +1,159 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "labpack.h"
+#include "labpack-private.h"
+#include "labpack-schema-private.h"
+
+static labpack_schema_t OUT_OF_MEMORY_SCHEMA = {
+    LABPACK_STATUS_ERROR_OUT_OF_MEMORY,              // status
+    "Not enough memory available to create schema", // status message
+    0,                                               // count
+    NULL,                                            // fields
+    NULL,                                            // keyset
+    { NULL, NULL, NULL, NULL }                       // allocator
+};
+
+static bool
+labpack_schema_is_supported(const labpack_field_t* field)
+{
+    switch (field->type) {
+        case LABPACK_TYPE_BOOL: return field->size == sizeof(bool);
+        case LABPACK_TYPE_INT:
+        case LABPACK_TYPE_UINT: return field->size == 1 || field->size == 2 || field->size == 4 || field->size == 8;
+        case LABPACK_TYPE_FLOAT: return field->size == sizeof(float);
+        case LABPACK_TYPE_DOUBLE: return field->size == sizeof(double);
+        case LABPACK_TYPE_STR: return field->size > 0;
+        default: return false;
+    }
+}
+
+static void
+labpack_schema_init(labpack_schema_t* schema, const labpack_field_t* fields, uint32_t count)
+{
+    schema->status = LABPACK_STATUS_OK;
+    schema->status_message = labpack_status_string(schema->status);
+    schema->count = count;
+    schema->fields = NULL;
+    schema->keyset = NULL;
+    if (fields == NULL && count > 0) {
+        schema->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+        schema->status_message = "The fields cannot be NULL";
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (!labpack_schema_is_supported(&fields[i])) {
+            schema->status = LABPACK_STATUS_ERROR_INVALID_ARGUMENT;
+            schema->status_message = "A field has an unsupported type or size";
+            return;
+        }
+    }
+    schema->fields = labpack_allocate(&schema->allocator, (count > 0 ? count : 1) * sizeof(labpack_field_t));
+    const char** names = labpack_allocate(&schema->allocator, (count > 0 ? count : 1) * sizeof(const char*));
+    if (schema->fields && names) {
+        for (uint32_t i = 0; i < count; i++) {
+            schema->fields[i] = fields[i];
+            // The key set keeps its own copy of the names
+            schema->fields[i].name = NULL;
+            names[i] = fields[i].name;
+        }
+        schema->keyset = labpack_keyset_create(names, count);
+        if (labpack_keyset_is_error(schema->keyset)) {
+            schema->status = labpack_keyset_status(schema->keyset);
+            schema->status_message = labpack_keyset_status_message(schema->keyset);
+        }
+    } else {
+        schema->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+        schema->status_message = "Not enough memory available to build schema";
+    }
+    labpack_release(&schema->allocator, (void*)names);
+}
+
+labpack_schema_t*
+labpack_schema_create(const labpack_field_t* fields, uint32_t count)
+{
+    const labpack_allocator_t* allocator = labpack_current_allocator();
+    labpack_schema_t* schema = labpack_allocate(allocator, sizeof(labpack_schema_t));
+    if (schema == NULL) {
+        return &OUT_OF_MEMORY_SCHEMA;
+    }
+    schema->allocator = *allocator;
+    labpack_schema_init(schema, fields, count);
+    return schema;
+}
+
+void
+labpack_schema_destroy(labpack_schema_t* schema)
+{
+    if (schema == NULL || schema == &OUT_OF_MEMORY_SCHEMA) {
+        return;
+    }
+    labpack_keyset_destroy(schema->keyset);
+    labpack_allocator_t allocator = schema->allocator;
+    labpack_release(&allocator, schema->fields);
+    labpack_release(&allocator, schema);
+}
+
+labpack_status_t
+labpack_schema_status(labpack_schema_t* schema)
+{
+    assert(schema);
+    return schema->status;
+}
+
+const char*
+labpack_schema_status_message(labpack_schema_t* schema)
+{
+    assert(schema);
+    return schema->status_message;
+}
+
+bool
+labpack_schema_is_ok(labpack_schema_t* schema)
+{
+    assert(schema);
+    return schema->status == LABPACK_STATUS_OK;
+}
+
+bool
+labpack_schema_is_error(labpack_schema_t* schema)
+{
+    assert(schema);
+    return schema->status != LABPACK_STATUS_OK;
+}
+
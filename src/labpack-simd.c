@@ -0,0 +1,359 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mpack.h"
+
+#include "labpack.h"
+#include "labpack-simd-private.h"
+
+// The x86 kernels are compiled for their instruction set with the target
+// attribute and selected when the library is loaded, so one library runs on
+// any x86 processor. Other processors and compilers use the scalar kernels.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LABPACK_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define LABPACK_SIMD_X86 0
+#endif
+
+#define ASCII_MASK UINT64_C(0x8080808080808080)
+
+typedef struct _labpack_kernels {
+    size_t (*ascii_prefix)(const uint8_t* bytes, size_t count);
+    void (*byteswap)(char* data, size_t count, size_t size);
+} labpack_kernels_t;
+
+static size_t
+labpack_scalar_ascii_prefix(const uint8_t* bytes, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        if (word & ASCII_MASK) {
+            break;
+        }
+    }
+    while (i < count && bytes[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+static void
+labpack_scalar_byteswap(char* data, size_t count, size_t size)
+{
+    for (size_t i = 0; i < count; i++) {
+        char* element = data + i * size;
+        switch (size) {
+            case 2: { uint16_t value = mpack_load_u16(element); memcpy(element, &value, sizeof(value)); break; }
+            case 4: { uint32_t value = mpack_load_u32(element); memcpy(element, &value, sizeof(value)); break; }
+            case 8: { uint64_t value = mpack_load_u64(element); memcpy(element, &value, sizeof(value)); break; }
+            default: return;
+        }
+    }
+}
+
+static const labpack_kernels_t SCALAR_KERNELS = {
+    labpack_scalar_ascii_prefix,
+    labpack_scalar_byteswap
+};
+
+#if LABPACK_SIMD_X86
+
+// The byte order of each element is reversed with a shuffle, which works
+// within each 16-byte lane, so the same pattern is repeated for every lane.
+#define SHUFFLE_U16 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1
+#define SHUFFLE_U32 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3
+#define SHUFFLE_U64 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7
+
+__attribute__((target("sse4.2")))
+static __m128i
+labpack_sse42_shuffle(size_t size)
+{
+    switch (size) {
+        case 2: return _mm_set_epi8(SHUFFLE_U16);
+        case 4: return _mm_set_epi8(SHUFFLE_U32);
+        default: return _mm_set_epi8(SHUFFLE_U64);
+    }
+}
+
+__attribute__((target("sse4.2")))
+static size_t
+labpack_sse42_ascii_prefix(const uint8_t* bytes, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(bytes + i)));
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz((unsigned int)mask);
+        }
+    }
+    return i + labpack_scalar_ascii_prefix(bytes + i, count - i);
+}
+
+__attribute__((target("sse4.2")))
+static void
+labpack_sse42_byteswap(char* data, size_t count, size_t size)
+{
+    if (size != 2 && size != 4 && size != 8) {
+        return;
+    }
+    const __m128i shuffle = labpack_sse42_shuffle(size);
+    size_t bytes = count * size;
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+        _mm_storeu_si128((__m128i*)(data + i), _mm_shuffle_epi8(chunk, shuffle));
+    }
+    labpack_scalar_byteswap(data + i, (bytes - i) / size, size);
+}
+
+static const labpack_kernels_t SSE42_KERNELS = {
+    labpack_sse42_ascii_prefix,
+    labpack_sse42_byteswap
+};
+
+__attribute__((target("avx2")))
+static size_t
+labpack_avx2_ascii_prefix(const uint8_t* bytes, size_t count)
+{
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        int mask = _mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(bytes + i)));
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz((unsigned int)mask);
+        }
+    }
+    return i + labpack_sse42_ascii_prefix(bytes + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void
+labpack_avx2_byteswap(char* data, size_t count, size_t size)
+{
+    if (size != 2 && size != 4 && size != 8) {
+        return;
+    }
+    const __m128i lane = labpack_sse42_shuffle(size);
+    const __m256i shuffle = _mm256_broadcastsi128_si256(lane);
+    size_t bytes = count * size;
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)(data + i));
+        _mm256_storeu_si256((__m256i*)(data + i), _mm256_shuffle_epi8(chunk, shuffle));
+    }
+    labpack_sse42_byteswap(data + i, (bytes - i) / size, size);
+}
+
+static const labpack_kernels_t AVX2_KERNELS = {
+    labpack_avx2_ascii_prefix,
+    labpack_avx2_byteswap
+};
+
+__attribute__((target("avx512f,avx512bw")))
+static size_t
+labpack_avx512_ascii_prefix(const uint8_t* bytes, size_t count)
+{
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t mask = _mm512_movepi8_mask(_mm512_loadu_si512((const void*)(bytes + i)));
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctzll(mask);
+        }
+    }
+    return i + labpack_avx2_ascii_prefix(bytes + i, count - i);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void
+labpack_avx512_byteswap(char* data, size_t count, size_t size)
+{
+    if (size != 2 && size != 4 && size != 8) {
+        return;
+    }
+    const __m128i lane = labpack_sse42_shuffle(size);
+    const __m512i shuffle = _mm512_broadcast_i32x4(lane);
+    size_t bytes = count * size;
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        __m512i chunk = _mm512_loadu_si512((const void*)(data + i));
+        _mm512_storeu_si512((void*)(data + i), _mm512_shuffle_epi8(chunk, shuffle));
+    }
+    labpack_avx2_byteswap(data + i, (bytes - i) / size, size);
+}
+
+static const labpack_kernels_t AVX512_KERNELS = {
+    labpack_avx512_ascii_prefix,
+    labpack_avx512_byteswap
+};
+
+#endif
+
+static labpack_simd_t current_simd = LABPACK_SIMD_SCALAR;
+static const labpack_kernels_t* current_kernels = &SCALAR_KERNELS;
+
+bool
+labpack_simd_is_supported(labpack_simd_t simd)
+{
+    switch (simd) {
+        case LABPACK_SIMD_SCALAR: return true;
+#if LABPACK_SIMD_X86
+        case LABPACK_SIMD_SSE42: return __builtin_cpu_supports("sse4.2");
+        case LABPACK_SIMD_AVX2: return __builtin_cpu_supports("avx2");
+        case LABPACK_SIMD_AVX512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+        default: return false;
+    }
+}
+
+labpack_simd_t
+labpack_simd()
+{
+    return current_simd;
+}
+
+bool
+labpack_set_simd(labpack_simd_t simd)
+{
+    if (!labpack_simd_is_supported(simd)) {
+        return false;
+    }
+    switch (simd) {
+#if LABPACK_SIMD_X86
+        case LABPACK_SIMD_SSE42: current_kernels = &SSE42_KERNELS; break;
+        case LABPACK_SIMD_AVX2: current_kernels = &AVX2_KERNELS; break;
+        case LABPACK_SIMD_AVX512: current_kernels = &AVX512_KERNELS; break;
+#endif
+        default: current_kernels = &SCALAR_KERNELS; break;
+    }
+    current_simd = simd;
+    return true;
+}
+
+#if LABPACK_SIMD_X86
+/**
+ * Selects the widest supported instruction set when the library is loaded,
+ * before any handle can be used.
+ */
+__attribute__((constructor))
+static void
+labpack_simd_select()
+{
+    // The processor features are not guaranteed to be detected yet while
+    // the constructors of a library run.
+    __builtin_cpu_init();
+    labpack_simd_t simd = LABPACK_SIMD_AVX512;
+    while (!labpack_set_simd(simd)) {
+        simd = (labpack_simd_t)(simd - 1);
+    }
+}
+#endif
+
+/**
+ * Gets the length of the valid multi-byte UTF-8 sequence at the start of the
+ * bytes, or zero (0) if it is not valid. The rules are the same as MPack,
+ * which rejects overlong sequences, surrogates, and code points above
+ * U+10FFFF.
+ */
+static size_t
+labpack_utf8_sequence(const uint8_t* bytes, size_t count)
+{
+    uint8_t lead = bytes[0];
+    size_t length = 0;
+    uint32_t codepoint = 0;
+    uint32_t minimum = 0;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 2;
+        codepoint = lead & 0x1F;
+        minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 3;
+        codepoint = lead & 0x0F;
+        minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 4;
+        codepoint = lead & 0x07;
+        minimum = 0x10000;
+    } else {
+        // A continuation byte without a lead, or a lead of 5 bytes or more
+        return 0;
+    }
+    if (count < length) {
+        return 0;
+    }
+    for (size_t i = 1; i < length; i++) {
+        if ((bytes[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+    }
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        return 0;
+    }
+    return length;
+}
+
+bool
+labpack_simd_utf8_check(const char* data, size_t count)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    size_t i = 0;
+    while (i < count) {
+        if (bytes[i] < 0x80) {
+            i += current_kernels->ascii_prefix(bytes + i, count - i);
+            continue;
+        }
+        size_t length = labpack_utf8_sequence(bytes + i, count - i);
+        if (length == 0) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+void
+labpack_simd_byteswap(char* data, size_t count, size_t size)
+{
+    assert(size == 1 || size == 2 || size == 4 || size == 8);
+    if (size > 1) {
+        current_kernels->byteswap(data, count, size);
+    }
+}
@@ -46,6 +46,8 @@ labpack_status_code(labpack_status_t status) {
         case LABPACK_STATUS_ERROR_NULL_VALUE: return -2;                                     
         case LABPACK_STATUS_ERROR_ENCODER: return -3;
         case LABPACK_STATUS_ERROR_DECODER: return -4;
+        case LABPACK_STATUS_ERROR_IO: return -5;
+        case LABPACK_STATUS_ERROR_INVALID_ARGUMENT: return -6;
         default: assert(UNKNOWN_STATUS);
     }
     return 1;
@@ -59,6 +61,8 @@ labpack_status_string(labpack_status_t status) {
         case LABPACK_STATUS_ERROR_NULL_VALUE: return "Null Value Error";
         case LABPACK_STATUS_ERROR_ENCODER: return "Encoder Error";
         case LABPACK_STATUS_ERROR_DECODER: return "Decoder Error";
+        case LABPACK_STATUS_ERROR_IO: return "IO Error";
+        case LABPACK_STATUS_ERROR_INVALID_ARGUMENT: return "Invalid Argument Error";
         default: assert(UNKNOWN_STATUS);
     }
     return UNKNOWN_STATUS;
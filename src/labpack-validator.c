@@ -0,0 +1,230 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <assert.h>
+
+#include "labpack.h"
+#include "labpack-private.h"
+
+void
+labpack_scanner_init(labpack_scanner_t* scanner, uint32_t max_depth, bool partial)
+{
+    assert(scanner);
+    if (max_depth > LABPACK_MAX_DEPTH) {
+        max_depth = LABPACK_MAX_DEPTH;
+    }
+    scanner->remaining = 1;
+    scanner->skip = 0;
+    scanner->position = 0;
+    scanner->depth = 0;
+    scanner->max_depth = max_depth;
+    scanner->partial = partial;
+}
+
+labpack_scan_result_t
+labpack_scanner_resume(labpack_scanner_t* scanner, const char* data, size_t size)
+{
+    assert(scanner);
+    assert(scanner->position <= size);
+    // The remaining element count for the current level is kept in a local,
+    // so only the parents are stacked.
+    uint64_t* parents = scanner->parents;
+    uint64_t remaining = scanner->remaining;
+    uint32_t depth = scanner->depth;
+    size_t position = scanner->position;
+    const bool partial = scanner->partial;
+    labpack_scan_result_t result = LABPACK_SCAN_COMPLETE;
+    if (scanner->skip > 0) {
+        // Continue passing over the payload of an element that was split
+        // across feeds.
+        size_t available = size - position;
+        if (scanner->skip > available) {
+            scanner->skip -= available;
+            scanner->position = size;
+            return LABPACK_SCAN_INCOMPLETE;
+        }
+        position += (size_t)scanner->skip;
+        scanner->skip = 0;
+        while (remaining == 0 && depth > 0) {
+            remaining = parents[--depth];
+        }
+    }
+    while (remaining > 0) {
+        if (position >= size) {
+            result = partial ? LABPACK_SCAN_INCOMPLETE : LABPACK_SCAN_INVALID;
+            break;
+        }
+        const uint8_t* p = (const uint8_t*)data + position;
+        size_t available = size - position;
+        uint8_t tag = p[0];
+        size_t header = 1;
+        uint64_t payload = 0;
+        uint64_t children = 0;
+        if (tag <= 0x7f || tag >= 0xe0) {
+            // positive and negative fixint
+        } else if (tag <= 0x8f) {
+            children = (uint64_t)(tag & 0x0f) * 2;
+        } else if (tag <= 0x9f) {
+            children = tag & 0x0f;
+        } else if (tag <= 0xbf) {
+            payload = tag & 0x1f;
+        } else {
+            switch (tag) {
+                case 0xc0: case 0xc2: case 0xc3: break;
+                case 0xc4: case 0xd9: header = 2; break;
+                case 0xc5: case 0xda: header = 3; break;
+                case 0xc6: case 0xdb: header = 5; break;
+                case 0xc7: header = 2; break;
+                case 0xc8: header = 3; break;
+                case 0xc9: header = 5; break;
+                case 0xca: payload = 4; break;
+                case 0xcb: payload = 8; break;
+                case 0xcc: case 0xd0: payload = 1; break;
+                case 0xcd: case 0xd1: payload = 2; break;
+                case 0xce: case 0xd2: payload = 4; break;
+                case 0xcf: case 0xd3: payload = 8; break;
+                case 0xd4: payload = 2; break;
+                case 0xd5: payload = 3; break;
+                case 0xd6: payload = 5; break;
+                case 0xd7: payload = 9; break;
+                case 0xd8: payload = 17; break;
+                case 0xdc: case 0xde: header = 3; break;
+                case 0xdd: case 0xdf: header = 5; break;
+                default:
+                    // 0xc1 is never used
+                    result = LABPACK_SCAN_INVALID;
+                    break;
+            }
+            if (result == LABPACK_SCAN_INVALID) {
+                break;
+            }
+            if (header > available) {
+                // A split header is parsed again once all of it is present
+                result = partial ? LABPACK_SCAN_INCOMPLETE : LABPACK_SCAN_INVALID;
+                break;
+            }
+            uint64_t value = 0;
+            switch (header) {
+                case 2: value = p[1]; break;
+                case 3: value = ((uint64_t)p[1] << 8) | p[2]; break;
+                case 5:
+                    value = ((uint64_t)p[1] << 24) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 8) | p[4];
+                    break;
+            }
+            switch (tag) {
+                case 0xc7: case 0xc8: case 0xc9:
+                    // The extension type byte follows the length
+                    payload = value + 1;
+                    break;
+                case 0xdc: case 0xdd:
+                    children = value;
+                    break;
+                case 0xde: case 0xdf:
+                    children = value * 2;
+                    break;
+                default:
+                    if (header > 1) {
+                        payload = value;
+                    }
+            }
+        }
+        if (header + payload > available) {
+            if (!partial) {
+                result = LABPACK_SCAN_INVALID;
+                break;
+            }
+            // Elements with a payload never have children, so the element is
+            // counted now and the rest of its payload is skipped on resume.
+            remaining--;
+            scanner->skip = header + payload - available;
+            position = size;
+            result = LABPACK_SCAN_INCOMPLETE;
+            break;
+        }
+        remaining--;
+        if (children > 0) {
+            // Every child is at least one byte, so a count larger than the
+            // rest of the data can be rejected without walking the children.
+            // Partial data may still be followed by the children.
+            if (depth >= scanner->max_depth || (!partial && children > available - header)) {
+                result = LABPACK_SCAN_INVALID;
+                break;
+            }
+            parents[depth++] = remaining;
+            remaining = children;
+        }
+        position += (size_t)(header + payload);
+        while (remaining == 0 && depth > 0) {
+            remaining = parents[--depth];
+        }
+    }
+    if (result == LABPACK_SCAN_COMPLETE) {
+        // Ready for the object that follows
+        remaining = 1;
+    }
+    scanner->remaining = remaining;
+    scanner->depth = depth;
+    scanner->position = position;
+    return result;
+}
+
+labpack_status_t
+labpack_scan(const char* data, size_t size, uint32_t max_depth, size_t* length)
+{
+    labpack_scanner_t scanner;
+    labpack_scanner_init(&scanner, max_depth, false);
+    labpack_scan_result_t result = labpack_scanner_resume(&scanner, data, size);
+    *length = scanner.position;
+    return result == LABPACK_SCAN_COMPLETE ? LABPACK_STATUS_OK : LABPACK_STATUS_ERROR_DECODER;
+}
+
+labpack_status_t
+labpack_validate(const char* data, size_t size, uint32_t max_depth, size_t* error_offset)
+{
+    size_t length = 0;
+    labpack_status_t status = LABPACK_STATUS_OK;
+    if (!data && size > 0) {
+        status = LABPACK_STATUS_ERROR_NULL_VALUE;
+    } else {
+        status = labpack_scan(data, size, max_depth, &length);
+        if (status == LABPACK_STATUS_OK && length != size) {
+            status = LABPACK_STATUS_ERROR_DECODER;
+        }
+    }
+    if (error_offset) {
+        *error_offset = status == LABPACK_STATUS_OK ? 0 : length;
+    }
+    return status;
+}
@@ -37,12 +37,22 @@
 
 #include "mpack.h"
 
+#include "labpack.h"
+#include "labpack-private.h"
+
 struct _labpack_writer {
     mpack_writer_t* encoder;
     char* buffer;
     size_t size;
+    size_t capacity;
     labpack_status_t status;
     const char* status_message;
+    uint32_t depth;
+    bool ended;
+    labpack_stats_t stats;
+    labpack_allocator_t allocator;
+    labpack_histogram_t* latency;
+    uint64_t started;
 };
 
 #endif
@@ -38,27 +38,65 @@
 
 #include "labpack.h"
 #include "labpack-private.h"
+#include "labpack-bool-private.h"
 #include "labpack-writer-private.h"
+#include "labpack-probes-private.h"
+#include "labpack-simd-private.h"
 
 static const char* NULL_STRING_MESSAGE = "The string value cannot be NULL while the length is greater than zero (0)";
 static const char* NULL_DATA_MESSAGE = "The data cannot be NULL while the count is greater than zero (0)";
 static const char* NULL_CSTR_MESSAGE = "The NUL-terminated string value cannot be NULL";
+static const char* UNBALANCED_MESSAGE = "The begin and end calls for maps, arrays, strings, binary blobs, and extension types are not balanced";
 
 static labpack_writer_t OUT_OF_MEMORY_WRITER = {
     NULL,                                          // encoder
     NULL,                                          // buffer
     0,                                             // size
+    0,                                             // capacity
     LABPACK_STATUS_ERROR_OUT_OF_MEMORY,            // status
-    "Not enough memory available to create writer" // status message
+    "Not enough memory available to create writer", // status message
+    0,                                              // depth
+    false,                                          // ended
+    { 0, 0, 0, 0, 0, 0, 0 },                        // stats
+    { NULL, NULL, NULL, NULL },                     // allocator
+    NULL,                                           // latency
+    0                                               // started
 };
 
+/**
+ * Raises the error of the encoder on the writer. mpack calls this only when
+ * the encoder is first flagged with an error, so the status stays current
+ * without checking the encoder again after every value is written.
+ */
 static void
-labpack_writer_check_encoder(labpack_writer_t* writer)
+labpack_writer_raise(mpack_writer_t* encoder, mpack_error_t error)
 {
-    mpack_error_t result = mpack_writer_error(writer->encoder);
-    if (result != mpack_ok) {
+    labpack_writer_t* writer = (labpack_writer_t*)encoder->context;
+    writer->status = LABPACK_STATUS_ERROR_ENCODER;
+    writer->status_message = labpack_mpack_error_message(error);
+    LABPACK_PROBE3(writer__error, writer, error, mpack_writer_buffer_used(encoder));
+}
+
+/**
+ * Tracks the nesting of begin and end calls. This is much cheaper than the
+ * write tracking of mpack, which is compiled out of performance builds, but
+ * still catches an end without a begin and a message left unfinished.
+ */
+static void
+labpack_writer_enter(labpack_writer_t* writer)
+{
+    writer->depth += 1;
+}
+
+static void
+labpack_writer_leave(labpack_writer_t* writer)
+{
+    if (writer->depth > 0) {
+        writer->depth -= 1;
+    } else {
+        mpack_writer_flag_error(writer->encoder, mpack_error_bug);
         writer->status = LABPACK_STATUS_ERROR_ENCODER;
-        writer->status_message = labpack_mpack_error_message(result);
+        writer->status_message = UNBALANCED_MESSAGE;
     }
 }
 
@@ -66,6 +104,11 @@ static void
 labpack_writer_reset_status(labpack_writer_t* writer)
 {
     assert(writer);
+    // An error is counted when it is cleared, or when the stats are gathered,
+    // so raising one does not need to be counted at every place it occurs.
+    if (writer->status != LABPACK_STATUS_OK) {
+        writer->stats.errors += 1;
+    }
     writer->status = LABPACK_STATUS_OK;        
     writer->status_message = labpack_status_string(writer->status);
 }
@@ -74,7 +117,9 @@ static void
 labpack_writer_init(labpack_writer_t* writer)
 {
     assert(writer);
-    writer->encoder = malloc(sizeof(mpack_writer_t));
+    memset(&writer->stats, 0, sizeof(writer->stats));
+    writer->status = LABPACK_STATUS_OK;
+    writer->encoder = labpack_allocate(&writer->allocator, sizeof(mpack_writer_t));
     if (writer->encoder) {
         labpack_writer_reset_status(writer);
     } else {
@@ -83,15 +128,30 @@ labpack_writer_init(labpack_writer_t* writer)
     }
     writer->buffer = NULL;
     writer->size = 0;
+    writer->capacity = 0;
+    writer->depth = 0;
+    writer->ended = false;
+    writer->latency = NULL;
+    writer->started = 0;
 }
 
 labpack_writer_t*
 labpack_writer_create() 
 {
-    labpack_writer_t* writer = malloc(sizeof(labpack_writer_t));
+    return labpack_writer_create_with_allocator(NULL);
+}
+
+labpack_writer_t*
+labpack_writer_create_with_allocator(const labpack_allocator_t* allocator)
+{
+    if (allocator == NULL) {
+        allocator = labpack_current_allocator();
+    }
+    labpack_writer_t* writer = labpack_allocate(allocator, sizeof(labpack_writer_t));
     if (writer == NULL) {
         return &OUT_OF_MEMORY_WRITER;
     }
+    writer->allocator = *allocator;
     labpack_writer_init(writer);
     return writer;
 }
@@ -99,34 +159,118 @@ labpack_writer_create()
 void
 labpack_writer_destroy(labpack_writer_t* writer)
 {
+    if (writer == &OUT_OF_MEMORY_WRITER) {
+        return;
+    }
+    // The writer is freed with a copy, since the allocator is inside of it
+    labpack_allocator_t allocator = writer->allocator;
     writer->size = 0;
-    free(writer->buffer);
+    labpack_release(&allocator, writer->buffer);
     writer->buffer = NULL;
-    free(writer->encoder);
+    labpack_release(&allocator, writer->encoder);
     writer->encoder = NULL;
-    free(writer);
+    labpack_release(&allocator, writer->latency);
+    writer->latency = NULL;
+    labpack_release(&allocator, writer);
+}
+
+/**
+ * Grows the buffer instead of emptying it when the encoder flushes, like
+ * the growable writer of mpack, but keeps the buffer owned by the writer.
+ */
+static void
+labpack_writer_grow(mpack_writer_t* encoder, const char* data, size_t count)
+{
+    labpack_writer_t* writer = (labpack_writer_t*)encoder->context;
+    if (data == encoder->buffer) {
+        if (mpack_writer_buffer_used(encoder) == count) {
+            // The encoder is being destroyed, so the data stays in place
+            return;
+        }
+        // The buffer is full, so the data is restored and the buffer grown
+        encoder->current = encoder->buffer + count;
+        count = 0;
+    }
+    size_t used = mpack_writer_buffer_used(encoder);
+    if (count > SIZE_MAX - used) {
+        mpack_writer_flag_error(encoder, mpack_error_too_big);
+        return;
+    }
+    size_t needed = used + count;
+    size_t capacity = mpack_writer_buffer_size(encoder);
+    do {
+        capacity = capacity > SIZE_MAX / 2 ? needed : capacity * 2;
+    } while (capacity < needed);
+    char* buffer = labpack_reallocate(&writer->allocator, encoder->buffer, capacity);
+    if (!buffer) {
+        mpack_writer_flag_error(encoder, mpack_error_memory);
+        return;
+    }
+    LABPACK_PROBE3(writer__grow, writer, writer->capacity, capacity);
+    writer->stats.reallocations += 1;
+    writer->stats.bytes_copied += used;
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+    encoder->buffer = buffer;
+    encoder->current = buffer + used;
+    encoder->end = buffer + capacity;
+    if (count > 0) {
+        memcpy(encoder->current, data, count);
+        encoder->current += count;
+    }
 }
 
 void
 labpack_writer_begin(labpack_writer_t* writer)
 {
     assert(writer);
-    mpack_writer_init_growable(writer->encoder, &writer->buffer, &writer->size);
-    if (mpack_writer_error(writer->encoder) != mpack_ok) {
-        writer->status = LABPACK_STATUS_ERROR_ENCODER;
-        writer->status_message = mpack_error_to_string(mpack_writer_error(writer->encoder));
+    if (!writer->encoder) {
+        return;
     }
+    writer->started = labpack_latency_start(writer->latency);
     labpack_writer_reset_status(writer);
+    writer->size = 0;
+    writer->depth = 0;
+    writer->ended = false;
+    // The buffer is kept between messages, so it only grows while messages
+    // get larger and is not allocated again for every message.
+    if (!writer->buffer) {
+        writer->buffer = labpack_allocate(&writer->allocator, MPACK_BUFFER_SIZE);
+        if (!writer->buffer) {
+            mpack_writer_init_error(writer->encoder, mpack_error_memory);
+            writer->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+            writer->status_message = "Not enough memory available for the encoding buffer";
+            return;
+        }
+        writer->capacity = MPACK_BUFFER_SIZE;
+        writer->stats.allocations += 1;
+    }
+    mpack_writer_init(writer->encoder, writer->buffer, writer->capacity);
+    mpack_writer_set_context(writer->encoder, writer);
+    mpack_writer_set_flush(writer->encoder, labpack_writer_grow);
+    mpack_writer_set_error_handler(writer->encoder, labpack_writer_raise);
+    LABPACK_PROBE1(writer__begin, writer);
 }
 
 void
 labpack_writer_end(labpack_writer_t* writer)
 {
     assert(writer);
-    if (mpack_writer_destroy(writer->encoder) != mpack_ok) {
+    if (writer->depth > 0 && labpack_writer_is_ok(writer)) {
+        mpack_writer_flag_error(writer->encoder, mpack_error_bug);
         writer->status = LABPACK_STATUS_ERROR_ENCODER;
-        writer->status_message = mpack_error_to_string(mpack_writer_error(writer->encoder));
+        writer->status_message = UNBALANCED_MESSAGE;
+    }
+    // Any error found while finishing the message is raised by the handler
+    mpack_writer_destroy(writer->encoder);
+    if (labpack_writer_is_ok(writer)) {
+        writer->size = mpack_writer_buffer_used(writer->encoder);
+        writer->stats.bytes += writer->size;
     }
+    writer->ended = true;
+    LABPACK_PROBE3(writer__end, writer, writer->size, writer->status);
+    labpack_latency_stop(writer->latency, LABPACK_LATENCY_MESSAGE, writer->started);
+    writer->started = 0;
 }
 
 labpack_status_t
@@ -178,22 +322,77 @@ labpack_writer_buffer_data(labpack_writer_t* writer, char* buffer)
             writer->status_message = "The buffer cannot be NULL";
             return;
         }
-        if (!writer->buffer) {
+        if (!writer->ended) {
             writer->status = LABPACK_STATUS_ERROR_ENCODER;
             writer->status_message = "The encoder is not done";
+            LABPACK_PROBE3(writer__error, writer, mpack_error_bug, writer->size);
             return;
         }
         memcpy(buffer, writer->buffer, writer->size);
+        writer->stats.bytes_copied += writer->size;
+    }
+}
+
+void
+labpack_writer_stats(labpack_writer_t* writer, labpack_stats_t* stats)
+{
+    assert(writer);
+    assert(stats);
+    *stats = writer->stats;
+    if (labpack_writer_is_error(writer)) {
+        stats->errors += 1;
+    }
+}
+
+void
+labpack_writer_footprint(labpack_writer_t* writer, labpack_footprint_t* footprint)
+{
+    assert(writer);
+    assert(footprint);
+    // The buffer only grows, so its peak is its capacity
+    footprint->buffer = writer->capacity;
+    footprint->peak_buffer = writer->capacity;
+    footprint->arena = 0;
+    footprint->peak_arena = 0;
+    footprint->mapped = 0;
+    footprint->peak_mapped = 0;
+}
+
+void
+labpack_writer_set_latency(labpack_writer_t* writer, bool enabled)
+{
+    assert(writer);
+    if (labpack_writer_is_ok(writer)) {
+        writer->latency = labpack_latency_set(&writer->allocator, writer->latency, enabled);
+        writer->started = 0;
+        if (enabled && !writer->latency) {
+            writer->status = LABPACK_STATUS_ERROR_OUT_OF_MEMORY;
+            writer->status_message = "Not enough memory available for the latency histograms";
+        }
     }
 }
 
+uint64_t
+labpack_writer_latency_histogram(labpack_writer_t* writer, labpack_latency_t latency, uint64_t* counts)
+{
+    assert(writer);
+    return labpack_latency_histogram(writer->latency, latency, counts);
+}
+
+uint64_t
+labpack_writer_latency_percentile(labpack_writer_t* writer, labpack_latency_t latency, double percentile)
+{
+    assert(writer);
+    return labpack_latency_percentile(writer->latency, latency, percentile);
+}
+
 void
 labpack_write_i8(labpack_writer_t* writer, int8_t value)
 {
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_i8(writer->encoder, value); 
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -203,7 +402,7 @@ labpack_write_i16(labpack_writer_t* writer, int16_t value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_i16(writer->encoder, value); 
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -213,7 +412,7 @@ labpack_write_i32(labpack_writer_t* writer, int32_t value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_i32(writer->encoder, value); 
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -223,7 +422,7 @@ labpack_write_i64(labpack_writer_t* writer, int64_t value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_i64(writer->encoder, value); 
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -233,7 +432,7 @@ labpack_write_int(labpack_writer_t* writer, int64_t value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_int(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -243,7 +442,7 @@ labpack_write_u8(labpack_writer_t* writer, uint8_t value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_u8(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -253,7 +452,7 @@ labpack_write_u16(labpack_writer_t* writer, uint16_t value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_u16(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -263,7 +462,7 @@ labpack_write_u32(labpack_writer_t* writer, uint32_t value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_u32(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -273,7 +472,7 @@ labpack_write_u64(labpack_writer_t* writer, uint64_t value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_u64(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -283,7 +482,7 @@ labpack_write_uint(labpack_writer_t* writer, uint64_t value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_uint(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -293,7 +492,7 @@ labpack_write_float(labpack_writer_t* writer, float value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_float(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -303,7 +502,7 @@ labpack_write_double(labpack_writer_t* writer, double value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_double(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -313,7 +512,7 @@ labpack_write_bool(labpack_writer_t* writer, bool value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_bool(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -323,7 +522,7 @@ labpack_write_true(labpack_writer_t* writer)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_true(writer->encoder);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -333,7 +532,7 @@ labpack_write_false(labpack_writer_t* writer)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_false(writer->encoder);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -343,7 +542,7 @@ labpack_write_nil(labpack_writer_t* writer)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_nil(writer->encoder);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -357,8 +556,83 @@ labpack_write_object_bytes(labpack_writer_t* writer, const char* data, size_t si
             writer->status_message = "The MessagePack object data is NULL but the size is not zero";
             return;
         }
+        uint64_t start = labpack_latency_start(writer->latency);
         mpack_write_object_bytes(writer->encoder, data, size);
-        labpack_writer_check_encoder(writer);
+        labpack_latency_stop(writer->latency, LABPACK_LATENCY_BULK, start);
+        writer->stats.elements += 1;
+    }
+}
+
+/**
+ * Writes an array of booleans from either the values or the bits.
+ */
+static void
+labpack_writer_write_bools(labpack_writer_t* writer, const bool* values, const uint8_t* bits, uint32_t count)
+{
+    mpack_writer_t* encoder = writer->encoder;
+    mpack_start_array(encoder, count);
+    uint32_t i = 0;
+#if MPACK_WRITE_TRACKING
+    for (; i < count && mpack_writer_error(encoder) == mpack_ok; i++) {
+        mpack_write_bool(encoder, values ? values[i] : (bits[i >> 3] >> (i & 7)) & 1);
+    }
+#else
+    // Each boolean is a single byte, so the elements are converted directly
+    // into the buffer without going through mpack for each one.
+    while (i < count && mpack_writer_error(encoder) == mpack_ok) {
+        size_t left = mpack_writer_buffer_left(encoder);
+        if (left == 0) {
+            // Writing one element grows or flushes the buffer
+            mpack_write_bool(encoder, values ? values[i] : (bits[i >> 3] >> (i & 7)) & 1);
+            i++;
+            continue;
+        }
+        size_t chunk = count - i < left ? count - i : left;
+        if (values) {
+            labpack_bool_encode(values + i, chunk, encoder->current);
+        } else {
+            labpack_bool_encode_bits(bits, i, chunk, encoder->current);
+        }
+        encoder->current += chunk;
+        i += (uint32_t)chunk;
+    }
+#endif
+    mpack_finish_array(encoder);
+}
+
+void
+labpack_write_bool_array(labpack_writer_t* writer, const bool* values, uint32_t count)
+{
+    assert(writer);
+    if (labpack_writer_is_ok(writer)) {
+        if (!values && count > 0) {
+            writer->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+            writer->status_message = NULL_DATA_MESSAGE;
+            return;
+        }
+        uint64_t start = labpack_latency_start(writer->latency);
+        labpack_writer_write_bools(writer, values, NULL, count);
+        labpack_latency_stop(writer->latency, LABPACK_LATENCY_BULK, start);
+        writer->stats.elements += 1 + (uint64_t)count;
+        writer->stats.containers += 1;
+    }
+}
+
+void
+labpack_write_bool_bitset(labpack_writer_t* writer, const uint8_t* bits, uint32_t count)
+{
+    assert(writer);
+    if (labpack_writer_is_ok(writer)) {
+        if (!bits && count > 0) {
+            writer->status = LABPACK_STATUS_ERROR_NULL_VALUE;
+            writer->status_message = NULL_DATA_MESSAGE;
+            return;
+        }
+        uint64_t start = labpack_latency_start(writer->latency);
+        labpack_writer_write_bools(writer, NULL, bits, count);
+        labpack_latency_stop(writer->latency, LABPACK_LATENCY_BULK, start);
+        writer->stats.elements += 1 + (uint64_t)count;
+        writer->stats.containers += 1;
     }
 }
 
@@ -368,7 +642,10 @@ labpack_writer_begin_array(labpack_writer_t* writer, uint32_t count)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_start_array(writer->encoder, count);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
+        writer->stats.containers += 1;
+        labpack_writer_enter(writer);
+        LABPACK_PROBE3(writer__container__begin, writer, LABPACK_TYPE_ARRAY, count);
     }
 }
 
@@ -378,7 +655,10 @@ labpack_writer_begin_map(labpack_writer_t* writer, uint32_t count)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_start_map(writer->encoder, count);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
+        writer->stats.containers += 1;
+        labpack_writer_enter(writer);
+        LABPACK_PROBE3(writer__container__begin, writer, LABPACK_TYPE_MAP, count);
     }
 }
 
@@ -387,8 +667,9 @@ labpack_writer_end_array(labpack_writer_t* writer)
 {
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
+        labpack_writer_leave(writer);
         mpack_finish_array(writer->encoder);
-        labpack_writer_check_encoder(writer);
+        LABPACK_PROBE2(writer__container__end, writer, LABPACK_TYPE_ARRAY);
     }
 }
 
@@ -397,8 +678,9 @@ labpack_writer_end_map(labpack_writer_t* writer)
 {
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
+        labpack_writer_leave(writer);
         mpack_finish_map(writer->encoder);
-        labpack_writer_check_encoder(writer);
+        LABPACK_PROBE2(writer__container__end, writer, LABPACK_TYPE_MAP);
     }
 }
 
@@ -413,8 +695,23 @@ labpack_write_str(labpack_writer_t* writer, const char* value, uint32_t length)
             return;
         }
         mpack_write_str(writer->encoder, value, length);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
+    }
+}
+
+/**
+ * Writes a string after checking that it is UTF-8, like
+ * <code>mpack_write_utf8</code> but with the check of the selected
+ * instruction set.
+ */
+static void
+labpack_writer_write_utf8(labpack_writer_t* writer, const char* value, size_t length)
+{
+    if (length > UINT32_MAX || !labpack_simd_utf8_check(value, length)) {
+        mpack_writer_flag_error(writer->encoder, mpack_error_invalid);
+        return;
     }
+    mpack_write_str(writer->encoder, value, (uint32_t)length);
 }
 
 void
@@ -427,8 +724,8 @@ labpack_write_utf8(labpack_writer_t* writer, const char* value, uint32_t length)
             writer->status_message = NULL_STRING_MESSAGE;
             return;
         }
-        mpack_write_utf8(writer->encoder, value, length);
-        labpack_writer_check_encoder(writer);
+        labpack_writer_write_utf8(writer, value, length);
+        writer->stats.elements += 1;
     }
 }
 
@@ -443,7 +740,7 @@ labpack_write_cstr(labpack_writer_t* writer, const char* value)
             return;
         }
         mpack_write_cstr(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -453,7 +750,7 @@ labpack_write_cstr_or_nil(labpack_writer_t* writer, const char* value)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_write_cstr_or_nil(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -467,8 +764,8 @@ labpack_write_utf8_cstr(labpack_writer_t* writer, const char* value)
             writer->status_message = NULL_CSTR_MESSAGE;
             return;
         }
-        mpack_write_utf8_cstr(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        labpack_writer_write_utf8(writer, value, strlen(value));
+        writer->stats.elements += 1;
     }
 }
 
@@ -477,8 +774,12 @@ labpack_write_utf8_cstr_or_nil(labpack_writer_t* writer, const char* value)
 {
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
-        mpack_write_utf8_cstr_or_nil(writer->encoder, value);
-        labpack_writer_check_encoder(writer);
+        if (value) {
+            labpack_writer_write_utf8(writer, value, strlen(value));
+        } else {
+            mpack_write_nil(writer->encoder);
+        }
+        writer->stats.elements += 1;
     }
 }
 
@@ -493,7 +794,7 @@ labpack_write_bin(labpack_writer_t* writer, const char* data, uint32_t count)
             return;
         }
         mpack_write_bin(writer->encoder, data, count);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -508,7 +809,7 @@ labpack_write_ext(labpack_writer_t* writer, int8_t type, const char* data, uint3
             return;
         }
         mpack_write_ext(writer->encoder, type, data, count);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
     }
 }
 
@@ -518,7 +819,8 @@ labpack_writer_begin_str(labpack_writer_t* writer, uint32_t count)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_start_str(writer->encoder, count);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
+        labpack_writer_enter(writer);
     }
 }
 
@@ -528,7 +830,8 @@ labpack_writer_begin_bin(labpack_writer_t* writer, uint32_t count)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_start_bin(writer->encoder, count);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
+        labpack_writer_enter(writer);
     }
 }
 
@@ -538,7 +841,8 @@ labpack_writer_begin_ext(labpack_writer_t* writer, int8_t type, uint32_t count)
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
         mpack_start_ext(writer->encoder, type, count);
-        labpack_writer_check_encoder(writer);
+        writer->stats.elements += 1;
+        labpack_writer_enter(writer);
     }
 }
 
@@ -553,7 +857,6 @@ labpack_write_bytes(labpack_writer_t* writer, const char* data, size_t count)
             return;
         }
         mpack_write_bytes(writer->encoder, data, count);
-        labpack_writer_check_encoder(writer);
     }
 }
 
@@ -562,8 +865,8 @@ labpack_writer_end_str(labpack_writer_t* writer)
 {
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
+        labpack_writer_leave(writer);
         mpack_finish_str(writer->encoder);
-        labpack_writer_check_encoder(writer);
     }
 }
 
@@ -572,8 +875,8 @@ labpack_writer_end_bin(labpack_writer_t* writer)
 {
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
+        labpack_writer_leave(writer);
         mpack_finish_bin(writer->encoder);
-        labpack_writer_check_encoder(writer);
     }
 }
 
@@ -582,8 +885,8 @@ labpack_writer_end_ext(labpack_writer_t* writer)
 {
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
+        labpack_writer_leave(writer);
         mpack_finish_ext(writer->encoder);
-        labpack_writer_check_encoder(writer);
     }
 }
 
@@ -592,8 +895,8 @@ labpack_writer_end_type(labpack_writer_t* writer, labpack_type_t type)
 {
     assert(writer);
     if (labpack_writer_is_ok(writer)) {
+        labpack_writer_leave(writer);
         mpack_finish_type(writer->encoder, labpack_to_mpack_type(type));
-        labpack_writer_check_encoder(writer);
     }
 }
 
@@ -73,6 +73,38 @@ labpack_to_mpack_type(labpack_type_t type)
     return mpack_type_nil;
 }
 
+labpack_type_t
+labpack_from_mpack_type(mpack_type_t type)
+{
+    switch (type) {
+        case mpack_type_nil:
+            return LABPACK_TYPE_NIL;
+        case mpack_type_bool:
+            return LABPACK_TYPE_BOOL;
+        case mpack_type_float:
+            return LABPACK_TYPE_FLOAT;
+        case mpack_type_double:
+            return LABPACK_TYPE_DOUBLE;
+        case mpack_type_int:
+            return LABPACK_TYPE_INT;
+        case mpack_type_uint:
+            return LABPACK_TYPE_UINT;
+        case mpack_type_str:
+            return LABPACK_TYPE_STR;
+        case mpack_type_bin:
+            return LABPACK_TYPE_BIN;
+        case mpack_type_ext:
+            return LABPACK_TYPE_EXT;
+        case mpack_type_array:
+            return LABPACK_TYPE_ARRAY;
+        case mpack_type_map:
+            return LABPACK_TYPE_MAP;
+        default:
+            assert(UNKNOWN_TYPE);
+    }
+    return LABPACK_TYPE_NIL;
+}
+
 const char*
 labpack_mpack_error_message(mpack_error_t error)
 {
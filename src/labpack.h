@@ -41,6 +41,8 @@
 #ifndef LABPACK_H
 #define LABPACK_H
 
+#include <stdio.h>
+
 #include "mpack.h"
 
 #ifdef __cplusplus
@@ -65,6 +67,21 @@ extern "C" {
 #  endif
 #endif
 
+/**
+ * The deepest nesting of maps and arrays that can be checked by the
+ * <code>labpack_validate</code> function.
+ */
+#define LABPACK_MAX_DEPTH 256
+
+/**
+ * The number of buckets in a latency histogram.
+ *
+ * Latencies in nanoseconds below 8 have a bucket each, and every power of two
+ * above that is split into 8 buckets, so a bucket is never wider than 12.5%
+ * of the latencies in it.
+ */
+#define LABPACK_LATENCY_BUCKETS 496
+
 /**
  * A MessagePack encoder.
  */
@@ -75,6 +92,16 @@ typedef struct _labpack_writer labpack_writer_t;
  */
 typedef struct _labpack_reader labpack_reader_t;
 
+/**
+ * A fixed set of map key names for fast key lookup while decoding.
+ */
+typedef struct _labpack_keyset labpack_keyset_t;
+
+/**
+ * A compiled record layout for decoding maps directly into structs.
+ */
+typedef struct _labpack_schema labpack_schema_t;
+
 /**
  * Status
  */
@@ -84,7 +111,9 @@ typedef enum _labpack_status {
     LABPACK_STATUS_ERROR_OUT_OF_MEMORY,
     LABPACK_STATUS_ERROR_NULL_VALUE,
     LABPACK_STATUS_ERROR_ENCODER,
-    LABPACK_STATUS_ERROR_DECODER
+    LABPACK_STATUS_ERROR_DECODER,
+    LABPACK_STATUS_ERROR_IO,
+    LABPACK_STATUS_ERROR_INVALID_ARGUMENT
 } labpack_status_t;
 
 /**
@@ -104,6 +133,114 @@ typedef enum _labpack_type {
     LABPACK_TYPE_MAP
 } labpack_type_t;
 
+/**
+ * The operations with a latency histogram.
+ *
+ * LABPACK_LATENCY_MESSAGE is the time from beginning a message to ending
+ * it, or to moving on with <code>labpack_reader_next_message</code>.
+ * LABPACK_LATENCY_BULK is the time of each single call that encodes or
+ * decodes many elements, such as the bool arrays, LabVIEW arrays, records,
+ * and object bytes.
+ */
+typedef enum _labpack_latency {
+    LABPACK_LATENCY_MESSAGE,
+    LABPACK_LATENCY_BULK
+} labpack_latency_t;
+
+/**
+ * The instruction sets of the kernels that check UTF-8 strings and swap the
+ * byte order of bulk arrays.
+ *
+ * The widest instruction set supported by the processor is selected when the
+ * library is loaded. LABPACK_SIMD_SSE42, LABPACK_SIMD_AVX2, and
+ * LABPACK_SIMD_AVX512 are only supported on x86 processors with a GCC or
+ * Clang build, and LABPACK_SIMD_AVX512 requires the AVX-512F and AVX-512BW
+ * extensions.
+ */
+typedef enum _labpack_simd {
+    LABPACK_SIMD_SCALAR,
+    LABPACK_SIMD_SSE42,
+    LABPACK_SIMD_AVX2,
+    LABPACK_SIMD_AVX512
+} labpack_simd_t;
+
+/**
+ * The description of one field of a record.
+ *
+ * The <code>name</code> is the map key, the <code>type</code> is the
+ * MessagePack type of the value, and the <code>offset</code> is the byte
+ * offset of the field within the record. The <code>size</code> is the size of
+ * the field in bytes: 1, 2, 4, or 8 for LABPACK_TYPE_INT and
+ * LABPACK_TYPE_UINT, the size of a <code>bool</code> for LABPACK_TYPE_BOOL, 4
+ * for LABPACK_TYPE_FLOAT, 8 for LABPACK_TYPE_DOUBLE, and the capacity of a
+ * fixed character array, including the NUL terminator, for LABPACK_TYPE_STR.
+ */
+typedef struct _labpack_field {
+    const char* name;
+    labpack_type_t type;
+    size_t offset;
+    size_t size;
+} labpack_field_t;
+
+/**
+ * Counters of the work done by a reader or writer since it was created.
+ *
+ * The <code>bytes</code> are the bytes consumed by a reader or produced by a
+ * writer, counted when it is ended without an error. The <code>elements</code> are the
+ * MessagePack elements read, skipped, or written, where maps, arrays, and
+ * each element of a bulk array count as elements. The
+ * <code>allocations</code> and <code>reallocations</code> are the internal
+ * buffers allocated and grown. The <code>bytes_copied</code> are the bytes
+ * moved by growing buffers and copied into or out of caller buffers. The
+ * <code>containers</code> are the maps and arrays opened, and the
+ * <code>errors</code> are the error states entered.
+ */
+typedef struct _labpack_stats {
+    uint64_t bytes;
+    uint64_t elements;
+    uint64_t allocations;
+    uint64_t reallocations;
+    uint64_t bytes_copied;
+    uint64_t containers;
+    uint64_t errors;
+} labpack_stats_t;
+
+/**
+ * The memory held by a reader or writer, in bytes.
+ *
+ * The <code>buffer</code> is the capacity of the encoding buffer of a
+ * writer, or of the stream or incremental buffer of a reader. The
+ * <code>arena</code> is the size of the arena of a reader, and the
+ * <code>mapped</code> is the size of the file mapped into memory by the
+ * <code>labpack_reader_begin_file</code> function. Each peak is the largest
+ * value since the handle was created, so a peak far above the typical
+ * message size shows a message that inflated the memory of the handle.
+ */
+typedef struct _labpack_footprint {
+    size_t buffer;
+    size_t peak_buffer;
+    size_t arena;
+    size_t peak_arena;
+    size_t mapped;
+    size_t peak_mapped;
+} labpack_footprint_t;
+
+/**
+ * The functions used to allocate, grow, and free memory.
+ *
+ * The <code>allocate</code>, <code>reallocate</code>, and
+ * <code>release</code> functions have the semantics of
+ * <code>malloc</code>, <code>realloc</code>, and <code>free</code>, and the
+ * <code>context</code> is passed to each of them unchanged, such as a memory
+ * pool. All three functions are required.
+ */
+typedef struct _labpack_allocator {
+    void* (*allocate)(void* context, size_t size);
+    void* (*reallocate)(void* context, void* pointer, size_t size);
+    void (*release)(void* context, void* pointer);
+    void* context;
+} labpack_allocator_t;
+
 /**
  * @defgroup utility Utility API
  *
@@ -145,6 +282,68 @@ LABPACK_API int labpack_status_code(labpack_status_t status);
  */
 LABPACK_API const char* labpack_status_string(labpack_status_t status);
 
+/**
+ * Gets the highest latency in nanoseconds that is counted in a bucket of a
+ * latency histogram.
+ */
+LABPACK_API uint64_t labpack_latency_bucket_limit(uint32_t bucket);
+
+/**
+ * Sets the allocator used by writers, readers, keysets, and schemas created
+ * afterwards, and by the internal encoder and decoder.
+ *
+ * The allocator is copied. A handle keeps the allocator it was created with
+ * until it is destroyed, so changing the allocator does not affect existing
+ * handles. A <code>NULL</code> allocator restores the C heap, which is the
+ * default. This is not thread-safe and should be called before any handles
+ * are created, such as during initialization of a real-time application.
+ */
+LABPACK_API void labpack_set_allocator(const labpack_allocator_t* allocator);
+
+/**
+ * Gets the bytes currently allocated by labpack across all handles,
+ * including the allocations of the internal encoder and decoder.
+ *
+ * Each allocation also requests a header of 16 bytes from the allocator,
+ * which is not included. The counter is updated atomically and can be read
+ * from any thread.
+ */
+LABPACK_API size_t labpack_allocated_bytes();
+
+/**
+ * Gets the most bytes allocated by labpack at once since the process started
+ * or since the <code>labpack_reset_peak_allocated_bytes</code> function was
+ * called, such as to size a memory pool.
+ */
+LABPACK_API size_t labpack_peak_allocated_bytes();
+
+/**
+ * Resets the peak of the bytes allocated by labpack to the bytes currently
+ * allocated, so the peak of a steady state can be measured after startup.
+ */
+LABPACK_API void labpack_reset_peak_allocated_bytes();
+
+/**
+ * Returns <code>true</code> if the kernels for the instruction set can run on
+ * this processor. LABPACK_SIMD_SCALAR is always supported.
+ */
+LABPACK_API bool labpack_simd_is_supported(labpack_simd_t simd);
+
+/**
+ * Gets the instruction set of the kernels in use.
+ */
+LABPACK_API labpack_simd_t labpack_simd();
+
+/**
+ * Forces the kernels of an instruction set, such as to test or compare each
+ * of them on one processor, and returns <code>false</code> without changing
+ * the kernels if the instruction set is not supported.
+ *
+ * This is not thread-safe and should not be called while any handle is in
+ * use on another thread.
+ */
+LABPACK_API bool labpack_set_simd(labpack_simd_t simd);
+
 /**
  * @}
  */
@@ -166,6 +365,17 @@ LABPACK_API const char* labpack_status_string(labpack_status_t status);
  */
 LABPACK_API labpack_writer_t* labpack_writer_create();
 
+/**
+ * Creates a MessagePack encoder that allocates all of its memory with the
+ * allocator instead of the allocator set with
+ * <code>labpack_set_allocator</code>.
+ *
+ * The allocator is copied and used until the encoder is destroyed. A
+ * <code>NULL</code> allocator is the same as
+ * <code>labpack_writer_create</code>.
+ */
+LABPACK_API labpack_writer_t* labpack_writer_create_with_allocator(const labpack_allocator_t* allocator);
+
 /**
  * Destroys (frees) a MessagePack encoder. Frees the memory allocated during
  * creation.
@@ -231,6 +441,57 @@ LABPACK_API size_t labpack_writer_buffer_size(labpack_writer_t* writer);
  */
 LABPACK_API void labpack_writer_buffer_data(labpack_writer_t* writer, char* buffer);
 
+/**
+ * Gets the counters of the writer.
+ *
+ * The counters only increase, so the difference between two calls is the
+ * work done in between. The encoding buffer is kept between messages and
+ * only grows, so the <code>reallocations</code> stop increasing once it fits
+ * the largest message. The counters are cheap enough to always be kept.
+ */
+LABPACK_API void labpack_writer_stats(labpack_writer_t* writer, labpack_stats_t* stats);
+
+/**
+ * Gets the memory held by the writer.
+ *
+ * The encoding buffer is kept between messages and only grows, so the
+ * <code>buffer</code> and <code>peak_buffer</code> are the same, and the
+ * <code>arena</code> and <code>mapped</code> are always zero (0) for a
+ * writer.
+ */
+LABPACK_API void labpack_writer_footprint(labpack_writer_t* writer, labpack_footprint_t* footprint);
+
+/**
+ * Enables or disables the latency histograms of the encoder.
+ *
+ * Enabling allocates the histograms with the allocator of the encoder and
+ * clears them, even if they are already enabled. Disabling frees them. The
+ * histograms are disabled by default, and reading the clock is skipped
+ * while they are.
+ */
+LABPACK_API void labpack_writer_set_latency(labpack_writer_t* writer, bool enabled);
+
+/**
+ * Copies the <code>LABPACK_LATENCY_BUCKETS</code> counts of a latency
+ * histogram of the encoder into the <code>counts</code> and returns the
+ * total count.
+ *
+ * The highest latency of each bucket is given by the
+ * <code>labpack_latency_bucket_limit</code> function. The counts are all
+ * zero (0) if the histograms are not enabled.
+ */
+LABPACK_API uint64_t labpack_writer_latency_histogram(labpack_writer_t* writer, labpack_latency_t latency, uint64_t* counts);
+
+/**
+ * Gets a percentile, from 0 to 100, of a latency histogram of the encoder in
+ * nanoseconds, such as 99.9 for the p999 latency.
+ *
+ * The result is the highest latency of the bucket containing the percentile
+ * and is never more than the highest latency recorded. Zero (0) is returned
+ * if nothing has been recorded.
+ */
+LABPACK_API uint64_t labpack_writer_latency_percentile(labpack_writer_t* writer, labpack_latency_t latency, double percentile);
+
 /**
  * Writes a signed 8-bit integer to the encoder's MessagePack data buffer.
  */
@@ -307,6 +568,28 @@ LABPACK_API void labpack_write_true(labpack_writer_t* writer);
  */
 LABPACK_API void labpack_write_false(labpack_writer_t* writer);
 
+/**
+ * Writes an array of <code>count</code> booleans.
+ *
+ * This is the same as writing an array with a call to the
+ * <code>labpack_write_bool</code> function for each element, but the
+ * elements are encoded in bulk. The <code>values</code> can be a LabVIEW
+ * Boolean array, where any non-zero byte is true. A
+ * LABPACK_STATUS_ERROR_NULL_VALUE error occurs if the <code>values</code> are
+ * NULL and the count is greater than zero (0).
+ */
+LABPACK_API void labpack_write_bool_array(labpack_writer_t* writer, const bool* values, uint32_t count);
+
+/**
+ * Writes an array of <code>count</code> booleans from a packed bitset.
+ *
+ * Element i is bit i % 8 of byte i / 8 of the <code>bits</code>, so the
+ * first element is the least significant bit of the first byte. A
+ * LABPACK_STATUS_ERROR_NULL_VALUE error occurs if the <code>bits</code> are
+ * NULL and the count is greater than zero (0).
+ */
+LABPACK_API void labpack_write_bool_bitset(labpack_writer_t* writer, const uint8_t* bits, uint32_t count);
+
 /**
  * Writes a Nil to the encoder's MessagePack data buffer.
  */
@@ -484,6 +767,17 @@ LABPACK_API void labpack_writer_end_type(labpack_writer_t* writer, labpack_type_
  */
 LABPACK_API labpack_reader_t* labpack_reader_create();
 
+/**
+ * Creates a MessagePack decoder that allocates all of its memory with the
+ * allocator instead of the allocator set with
+ * <code>labpack_set_allocator</code>.
+ *
+ * The allocator is copied and used until the decoder is destroyed. A
+ * <code>NULL</code> allocator is the same as
+ * <code>labpack_reader_create</code>.
+ */
+LABPACK_API labpack_reader_t* labpack_reader_create_with_allocator(const labpack_allocator_t* allocator);
+
 /**
  * Destroys (frees) a MessagePack decoder.
  */
@@ -514,16 +808,266 @@ LABPACK_API bool labpack_reader_is_error(labpack_reader_t* reader);
  */
 LABPACK_API void labpack_reader_begin(labpack_reader_t* reader, const char* data, size_t count);
 
+/**
+ * Begins reading and decoding MessagePack data from a C file stream.
+ *
+ * The data is read from the <code>file</code> in chunks of up to
+ * <code>buffer_size</code> bytes as it is decoded, so arbitrarily large
+ * files and streams can be decoded in constant memory. Skipped data is
+ * seeked over when the stream supports it. A <code>buffer_size</code> of
+ * zero (0) uses a default size of 4096 bytes, and very small sizes are
+ * increased to a minimum of 32 bytes. The buffer is kept between messages
+ * and freed when the reader is destroyed.
+ *
+ * The reader may read ahead of the data that has been decoded, so the
+ * stream should only be consumed through the reader until the
+ * <code>labpack_reader_end</code> function is called. Multiple messages can
+ * be decoded one after another before ending. The file is not closed by the
+ * reader.
+ *
+ * A LABPACK_STATUS_ERROR_NULL_VALUE error occurs if the <code>file</code> is
+ * NULL. Read errors and the end of the file are reported as decoder errors.
+ */
+LABPACK_API void labpack_reader_begin_stdfile(labpack_reader_t* reader, FILE* file, size_t buffer_size);
+
+/**
+ * Begins reading and decoding MessagePack data from a file descriptor.
+ *
+ * This is the same as the <code>labpack_reader_begin_stdfile</code> function
+ * but reads from a file descriptor, such as a file, pipe, or socket. The file
+ * descriptor is not closed by the reader.
+ *
+ * A LABPACK_STATUS_ERROR_NULL_VALUE error occurs if the <code>fd</code> is
+ * negative.
+ */
+LABPACK_API void labpack_reader_begin_fd(labpack_reader_t* reader, int fd, size_t buffer_size);
+
+/**
+ * Begins reading and decoding MessagePack data from a file.
+ *
+ * The file is memory-mapped read-only and decoded directly from the mapping,
+ * so the data is not copied into a buffer and the pages can be shared with
+ * other processes reading the same file through the operating system's page
+ * cache. The operating system is advised that the file will be read
+ * sequentially. The mapping is released by the <code>labpack_reader_end</code>
+ * function.
+ *
+ * A LABPACK_STATUS_ERROR_NULL_VALUE error occurs if the <code>path</code> is
+ * NULL, and a LABPACK_STATUS_ERROR_IO error occurs if the file cannot be
+ * opened or mapped.
+ */
+LABPACK_API void labpack_reader_begin_file(labpack_reader_t* reader, const char* path);
+
+/**
+ * Begins decoding MessagePack data that arrives in fragments.
+ *
+ * This is for data received in pieces of any size, such as from a
+ * non-blocking socket or a LabVIEW TCP Read in immediate mode. Each fragment
+ * is appended with the <code>labpack_reader_feed</code> function, and the
+ * <code>labpack_reader_next_message</code> function returns
+ * <code>true</code> once a complete message has been fed. Until then, it
+ * returns <code>false</code> without an error, which means more data is
+ * needed. Incomplete data is never decoded, so a message split across
+ * fragments does not cause a decoder error.
+ *
+ * The fed data is copied into a buffer owned by the reader, which grows to
+ * hold the largest message and is kept for the next use of the reader. Each
+ * call to the <code>labpack_reader_next_message</code> function continues
+ * checking the data from the last element that was complete, so the work
+ * done for a message is proportional to its size, not the number of
+ * fragments. A LABPACK_STATUS_ERROR_DECODER error occurs as soon as the fed
+ * data is not valid MessagePack or is nested deeper than
+ * <code>LABPACK_MAX_DEPTH</code>.
+ */
+LABPACK_API void labpack_reader_begin_incremental(labpack_reader_t* reader);
+
+/**
+ * Appends <code>count</code> bytes to the data of a reader begun with the
+ * <code>labpack_reader_begin_incremental</code> function.
+ *
+ * This can be called at any time, including part way through decoding a
+ * message, but feeding may move the buffered data, so any pointers into the
+ * data, such as those of sub-readers, are no longer valid afterwards.
+ *
+ * A LABPACK_STATUS_ERROR_INVALID_ARGUMENT error occurs if the reader was not
+ * begun for incremental decoding, and a LABPACK_STATUS_ERROR_NULL_VALUE error
+ * occurs if the <code>data</code> is NULL while the <code>count</code> is
+ * greater than zero (0).
+ */
+LABPACK_API void labpack_reader_feed(labpack_reader_t* reader, const char* data, size_t count);
+
 /**
  * Ends reading and decoding MessagePack data. 
  *
- * Frees resources and checks for any errors caused by incomplete decoding of
- * compound elements (maps and arrays).
+ * Frees resources, including any file mapping from the
+ * <code>labpack_reader_begin_file</code> function, and checks for any errors
+ * caused by incomplete decoding of compound elements (maps and arrays).
  *
  * An error status will be set if the reading is incomplete.
  */
 LABPACK_API void labpack_reader_end(labpack_reader_t* reader);
 
+/**
+ * Checks if another message follows the data that has been read.
+ *
+ * A single reader can decode a buffer, file, or stream containing many
+ * MessagePack messages back-to-back. Call this function before decoding each
+ * message; it returns <code>true</code> if there is at least one more byte
+ * to decode and <code>false</code> at the end of the data or if the reader
+ * is in an error state. For a stream, this may read more data into the
+ * buffer, and the end of the stream is not treated as an error.
+ * For incremental decoding, <code>false</code> without an error means the
+ * next message has not been completely fed yet.
+ *
+ * Each message must be read completely before calling this function again.
+ */
+LABPACK_API bool labpack_reader_next_message(labpack_reader_t* reader);
+
+/**
+ * Gets the number of bytes that have been decoded, or skipped, since the
+ * reader was begun.
+ *
+ * This is the byte offset of the next element in the data. When called
+ * between messages, it is the offset where the next message starts.
+ */
+LABPACK_API uint64_t labpack_reader_offset(labpack_reader_t* reader);
+
+/**
+ * Gets the counters of the reader.
+ *
+ * This is the same as the <code>labpack_writer_stats</code> function but for
+ * a reader.
+ */
+LABPACK_API void labpack_reader_stats(labpack_reader_t* reader, labpack_stats_t* stats);
+
+/**
+ * Gets the memory held by the reader.
+ *
+ * The buffer is reallocated when a stream is begun with a different buffer
+ * size, and the arena when the <code>labpack_reader_set_arena</code>
+ * function is called with a different size, so either can be less than its
+ * peak. The mapped file is unmapped when the next message source is begun or
+ * the reader is destroyed.
+ */
+LABPACK_API void labpack_reader_footprint(labpack_reader_t* reader, labpack_footprint_t* footprint);
+
+/**
+ * Enables or disables the latency histograms of the decoder.
+ *
+ * This is the same as the <code>labpack_writer_set_latency</code> function
+ * but for a decoder.
+ */
+LABPACK_API void labpack_reader_set_latency(labpack_reader_t* reader, bool enabled);
+
+/**
+ * Copies a latency histogram of the decoder and returns the total count.
+ *
+ * This is the same as the <code>labpack_writer_latency_histogram</code>
+ * function but for a decoder.
+ */
+LABPACK_API uint64_t labpack_reader_latency_histogram(labpack_reader_t* reader, labpack_latency_t latency, uint64_t* counts);
+
+/**
+ * Gets a percentile of a latency histogram of the decoder in nanoseconds.
+ *
+ * This is the same as the <code>labpack_writer_latency_percentile</code>
+ * function but for a decoder.
+ */
+LABPACK_API uint64_t labpack_reader_latency_percentile(labpack_reader_t* reader, labpack_latency_t latency, double percentile);
+
+/**
+ * Inspects the type of the next element without reading it.
+ *
+ * The type is stored in <code>type</code>. The number of elements for an
+ * array, the number of key-value pairs for a map, or the number of bytes for
+ * a string, binary blob, or extension type is stored in
+ * <code>count_or_length</code>; it is zero (0) for all other types. Either
+ * parameter may be NULL.
+ *
+ * The element is not consumed, so it can then be read with the
+ * <code>labpack_read_*</code> or <code>labpack_reader_begin_*</code> function
+ * for its type. This avoids attempting a read of the wrong type, which puts
+ * the reader into an error state. An integer is
+ * <code>LABPACK_TYPE_UINT</code> or <code>LABPACK_TYPE_INT</code> depending
+ * on how it was encoded, so either can hold a non-negative value.
+ *
+ * The decoder is placed into an error state if there is no next element or
+ * it is not valid MessagePack. In the error state, the type is
+ * <code>LABPACK_TYPE_NIL</code> and the count is zero (0).
+ */
+LABPACK_API void labpack_reader_peek(labpack_reader_t* reader, labpack_type_t* type, uint32_t* count_or_length);
+
+/**
+ * Skips the next <code>count</code> elements without decoding them.
+ *
+ * Each element is skipped completely, including all of the elements of a
+ * map or array. The bytes of a string, binary blob, or extension type are
+ * passed over directly without being copied, and are seeked over for a file
+ * stream when possible. This can be used to ignore unwanted values, such as
+ * the value of an unknown key in a map.
+ *
+ * The decoder is placed into an error state if there are fewer than
+ * <code>count</code> elements left or the data is not valid MessagePack.
+ */
+LABPACK_API void labpack_reader_skip(labpack_reader_t* reader, uint32_t count);
+
+/**
+ * Begins a child reader over the next element and skips the element.
+ *
+ * The <code>child</code> must be a different reader created with the
+ * <code>labpack_reader_create</code> function. It is begun over the bytes of
+ * the next element, such as an entire array, which are not copied, so the
+ * parent's data must remain valid until the child has been ended. For the
+ * <code>labpack_reader_begin_file</code> function, this means the parent must
+ * not be ended before the child. The child is otherwise independent of the
+ * parent, so a number of children can be decoded on different threads while
+ * the parent moves on to the following elements. The child must be ended with
+ * the <code>labpack_reader_end</code> function like any other reader.
+ *
+ * Sub-readers are only available for data in memory, so a
+ * LABPACK_STATUS_ERROR_INVALID_ARGUMENT error occurs if the parent is reading
+ * from a stream. If the parent is in, or enters, an error state, then the
+ * child is placed into the same error state.
+ */
+LABPACK_API void labpack_reader_subreader(labpack_reader_t* reader, labpack_reader_t* child);
+
+/**
+ * Reads a map key and returns its index in the key set.
+ *
+ * The key must be a string. It is compared in place against the names of the
+ * <code>keyset</code> using a perfect hash, so it is not copied and the cost
+ * does not depend on the number of names. The returned index is the position
+ * of the matching name in the array used to create the key set.
+ *
+ * Returns -1 if the key is not in the key set. The key is still consumed and
+ * the reader is not placed into an error state, so the value can be skipped
+ * with the <code>labpack_reader_skip</code> function. -1 is also returned if
+ * an error occurs, and the status of the key set is copied to the reader if
+ * the key set is in an error state.
+ *
+ * When reading from a stream, the buffer must be at least as large as the
+ * longest name in the key set.
+ */
+LABPACK_API int32_t labpack_reader_expect_key(labpack_reader_t* reader, labpack_keyset_t* keyset);
+
+/**
+ * Reads a map into a record with the layout described by a schema.
+ *
+ * The keys can be in any order. Each value whose key is a field of the
+ * <code>schema</code> is decoded and stored at the field's offset within
+ * <code>out</code>, and the values of unknown keys are skipped. Fields that
+ * are missing from the map are left unchanged, so the record should be
+ * initialized with default values beforehand. Strings are copied into the
+ * fixed character array of the field and NUL-terminated.
+ *
+ * The decoder is placed into an error state if the data is not a map, a key
+ * is not a string, a value does not match the type of its field or does not
+ * fit, or a string does not fit in its field. The status of the schema is
+ * copied to the reader if the schema is in an error state, and a
+ * LABPACK_STATUS_ERROR_NULL_VALUE error occurs if <code>out</code> is NULL.
+ */
+LABPACK_API void labpack_read_record(labpack_reader_t* reader, labpack_schema_t* schema, void* out);
+
 /**
  * Read an unsigned 8-bit integer.
  */
@@ -625,6 +1169,146 @@ LABPACK_API void labpack_read_true(labpack_reader_t* reader);
  */
 LABPACK_API void labpack_read_false(labpack_reader_t* reader);
 
+/**
+ * Reads an array of booleans and returns the number of elements.
+ *
+ * This is the same as reading an array with a call to the
+ * <code>labpack_read_bool</code> function for each element, but the
+ * elements are decoded in bulk. The <code>values</code> can be a LabVIEW
+ * Boolean array with room for <code>capacity</code> elements.
+ *
+ * The decoder is placed into an error state if the array has more than
+ * <code>capacity</code> elements or an element is not a boolean. A
+ * LABPACK_STATUS_ERROR_NULL_VALUE error occurs if the <code>values</code> are
+ * NULL and the capacity is greater than zero (0).
+ */
+LABPACK_API uint32_t labpack_read_bool_array(labpack_reader_t* reader, bool* values, uint32_t capacity);
+
+/**
+ * Reads an array of booleans into a packed bitset and returns the number of
+ * elements.
+ *
+ * Element i is stored in bit i % 8 of byte i / 8 of the <code>bits</code>,
+ * so the first element is the least significant bit of the first byte. The
+ * <code>bits</code> must have room for <code>capacity</code> bits, rounded up
+ * to a whole byte. Any unused bits of the last byte are cleared.
+ *
+ * The decoder is placed into an error state if the array has more than
+ * <code>capacity</code> elements or an element is not a boolean. A
+ * LABPACK_STATUS_ERROR_NULL_VALUE error occurs if the <code>bits</code> are
+ * NULL and the capacity is greater than zero (0).
+ */
+LABPACK_API uint32_t labpack_read_bool_bitset(labpack_reader_t* reader, uint8_t* bits, uint32_t capacity);
+
+/**
+ * Gets the number of bytes needed to hold a LabVIEW 1D array of
+ * <code>count</code> elements of <code>element_size</code> bytes each.
+ *
+ * This is the capacity needed by the <code>labpack_read_lv_array_*</code>
+ * functions, including the dimension size and any alignment padding. The
+ * count of the next array, or the byte length of the next extension type, can
+ * be found with the <code>labpack_reader_peek</code> function to size a
+ * LabVIEW array handle before reading.
+ */
+LABPACK_API size_t labpack_lv_array_size(size_t element_size, uint32_t count);
+
+/**
+ * Reads an array of signed 8-bit integers into the memory layout of a LabVIEW
+ * 1D array and returns the number of elements.
+ *
+ * The <code>out</code> buffer receives the number of elements as a 32-bit
+ * dimension size followed by the elements, both in native byte order. The
+ * elements start at their natural alignment after the dimension size, except
+ * on 32-bit Windows where LabVIEW data is packed, which is the same as the
+ * data of a LabVIEW array handle. A LabVIEW array of the exact size can
+ * then take the data with a single move, without an intermediate array or
+ * converting each element.
+ *
+ * The data may be a MessagePack array, where each element is converted to the
+ * element type, or an extension type of any type code whose payload is the
+ * elements packed in big-endian byte order.
+ *
+ * The decoder is placed into an error state if the elements do not fit in
+ * <code>capacity</code> bytes, see the <code>labpack_lv_array_size</code>
+ * function, an element cannot be converted without losing its value, or the
+ * payload of an extension type is not a whole number of elements. A
+ * LABPACK_STATUS_ERROR_NULL_VALUE error occurs if <code>out</code> is NULL
+ * and the capacity is greater than zero (0).
+ */
+LABPACK_API uint32_t labpack_read_lv_array_i8(labpack_reader_t* reader, char* out, size_t capacity);
+
+/**
+ * Reads an array of signed 16-bit integers into the memory layout of a
+ * LabVIEW 1D array and returns the number of elements.
+ *
+ * This is the same as the <code>labpack_read_lv_array_i8</code> function.
+ */
+LABPACK_API uint32_t labpack_read_lv_array_i16(labpack_reader_t* reader, char* out, size_t capacity);
+
+/**
+ * Reads an array of signed 32-bit integers into the memory layout of a
+ * LabVIEW 1D array and returns the number of elements.
+ *
+ * This is the same as the <code>labpack_read_lv_array_i8</code> function.
+ */
+LABPACK_API uint32_t labpack_read_lv_array_i32(labpack_reader_t* reader, char* out, size_t capacity);
+
+/**
+ * Reads an array of signed 64-bit integers into the memory layout of a
+ * LabVIEW 1D array and returns the number of elements.
+ *
+ * This is the same as the <code>labpack_read_lv_array_i8</code> function.
+ */
+LABPACK_API uint32_t labpack_read_lv_array_i64(labpack_reader_t* reader, char* out, size_t capacity);
+
+/**
+ * Reads an array of unsigned 8-bit integers into the memory layout of a
+ * LabVIEW 1D array and returns the number of elements.
+ *
+ * This is the same as the <code>labpack_read_lv_array_i8</code> function.
+ */
+LABPACK_API uint32_t labpack_read_lv_array_u8(labpack_reader_t* reader, char* out, size_t capacity);
+
+/**
+ * Reads an array of unsigned 16-bit integers into the memory layout of a
+ * LabVIEW 1D array and returns the number of elements.
+ *
+ * This is the same as the <code>labpack_read_lv_array_i8</code> function.
+ */
+LABPACK_API uint32_t labpack_read_lv_array_u16(labpack_reader_t* reader, char* out, size_t capacity);
+
+/**
+ * Reads an array of unsigned 32-bit integers into the memory layout of a
+ * LabVIEW 1D array and returns the number of elements.
+ *
+ * This is the same as the <code>labpack_read_lv_array_i8</code> function.
+ */
+LABPACK_API uint32_t labpack_read_lv_array_u32(labpack_reader_t* reader, char* out, size_t capacity);
+
+/**
+ * Reads an array of unsigned 64-bit integers into the memory layout of a
+ * LabVIEW 1D array and returns the number of elements.
+ *
+ * This is the same as the <code>labpack_read_lv_array_i8</code> function.
+ */
+LABPACK_API uint32_t labpack_read_lv_array_u64(labpack_reader_t* reader, char* out, size_t capacity);
+
+/**
+ * Reads an array of single-precision floating point numbers into the memory
+ * layout of a LabVIEW 1D array and returns the number of elements.
+ *
+ * This is the same as the <code>labpack_read_lv_array_i8</code> function.
+ */
+LABPACK_API uint32_t labpack_read_lv_array_float(labpack_reader_t* reader, char* out, size_t capacity);
+
+/**
+ * Reads an array of double-precision floating point numbers into the memory
+ * layout of a LabVIEW 1D array and returns the number of elements.
+ *
+ * This is the same as the <code>labpack_read_lv_array_i8</code> function.
+ */
+LABPACK_API uint32_t labpack_read_lv_array_double(labpack_reader_t* reader, char* out, size_t capacity);
+
 /**
  * Reads a map and returns the number of key-value elements.
  */
@@ -755,6 +1439,294 @@ LABPACK_API void labpack_reader_end_ext(labpack_reader_t* reader);
  */
 LABPACK_API void labpack_read_bytes(labpack_reader_t* reader, char* data, size_t count);
 
+/**
+ * Reads an entire string into a buffer.
+ *
+ * This is the same as the <code>labpack_reader_begin_str</code>,
+ * <code>labpack_read_bytes</code>, and <code>labpack_reader_end_str</code>
+ * functions in a single call. The bytes are copied into the
+ * <code>buffer</code>, which has room for <code>capacity</code> bytes, and
+ * are not NUL-terminated. The number of bytes is stored in the
+ * <code>length</code>, which can be NULL if it is not needed.
+ *
+ * The decoder is placed into an error state without copying any bytes if the
+ * string is longer than the <code>capacity</code>, but the
+ * <code>length</code> is still set to the length of the string so the
+ * required capacity is known. A LABPACK_STATUS_ERROR_NULL_VALUE error occurs
+ * if the <code>buffer</code> is NULL and the capacity is greater than zero
+ * (0).
+ */
+LABPACK_API void labpack_read_str_into(labpack_reader_t* reader, char* buffer, uint32_t capacity, uint32_t* length);
+
+/**
+ * Reads an entire binary blob into a buffer.
+ *
+ * This is the same as the <code>labpack_read_str_into</code> function but
+ * for a binary blob.
+ */
+LABPACK_API void labpack_read_bin_into(labpack_reader_t* reader, char* buffer, uint32_t capacity, uint32_t* length);
+
+/**
+ * Reads an entire extension type into a buffer.
+ *
+ * This is the same as the <code>labpack_read_str_into</code> function but
+ * for an extension type, where the <code>type</code> is also read.
+ */
+LABPACK_API void labpack_read_ext_into(labpack_reader_t* reader, int8_t* type, char* buffer, uint32_t capacity, uint32_t* length);
+
+/**
+ * Sets the size of the arena in bytes, which the
+ * <code>labpack_read_*_arena</code> functions decode into.
+ *
+ * The arena is allocated once here with the allocator of the reader and is
+ * reused for every message, so decoding does not allocate or free memory per
+ * object. Everything in the arena is released at once by
+ * <code>labpack_reader_end</code> and
+ * <code>labpack_reader_next_message</code>. A size of zero (0) frees the
+ * arena, which is the default. This should not be called while reading a
+ * message, since data already read into the arena is freed.
+ */
+LABPACK_API void labpack_reader_set_arena(labpack_reader_t* reader, size_t size);
+
+/**
+ * Reads an entire string into the arena.
+ *
+ * The returned string is NUL-terminated and stays valid until the message is
+ * ended. The number of bytes, without the NUL terminator, is stored in the
+ * <code>length</code>, which can be NULL if it is not needed. NULL is
+ * returned and the reader is placed into a
+ * LABPACK_STATUS_ERROR_OUT_OF_MEMORY error state if the string does not fit
+ * in the rest of the arena.
+ */
+LABPACK_API const char* labpack_read_str_arena(labpack_reader_t* reader, uint32_t* length);
+
+/**
+ * Reads an entire binary blob into the arena.
+ *
+ * This is the same as the <code>labpack_read_str_arena</code> function but
+ * for a binary blob, which is not NUL-terminated.
+ */
+LABPACK_API const char* labpack_read_bin_arena(labpack_reader_t* reader, uint32_t* length);
+
+/**
+ * Reads an entire extension type into the arena.
+ *
+ * This is the same as the <code>labpack_read_bin_arena</code> function but
+ * for an extension type, where the <code>type</code> is also read.
+ */
+LABPACK_API const char* labpack_read_ext_arena(labpack_reader_t* reader, int8_t* type, uint32_t* length);
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup keyset Key Set API
+ *
+ * Fast lookup of expected map key names.
+ *
+ * @{
+ */
+
+/**
+ * Creates a key set from an array of <code>count</code> NUL-terminated names.
+ *
+ * A minimal perfect hash of the names is built once when the key set is
+ * created, so each key can then be found with a single hash and comparison
+ * by the <code>labpack_reader_expect_key</code> function. The names are
+ * copied, so the array does not need to outlive the key set.
+ *
+ * A LABPACK_STATUS_ERROR_NULL_VALUE error occurs if the <code>names</code> or
+ * any name is NULL, and a LABPACK_STATUS_ERROR_INVALID_ARGUMENT error occurs
+ * if a name appears more than once.
+ */
+LABPACK_API labpack_keyset_t* labpack_keyset_create(const char** names, uint32_t count);
+
+/**
+ * Destroys a key set.
+ */
+LABPACK_API void labpack_keyset_destroy(labpack_keyset_t* keyset);
+
+/**
+ * Gets the status of the key set.
+ */
+LABPACK_API labpack_status_t labpack_keyset_status(labpack_keyset_t* keyset);
+
+/**
+ * Gets the status message of the key set.
+ */
+LABPACK_API const char* labpack_keyset_status_message(labpack_keyset_t* keyset);
+
+/**
+ * Checks if the key set is OK.
+ */
+LABPACK_API bool labpack_keyset_is_ok(labpack_keyset_t* keyset);
+
+/**
+ * Checks if the key set is in an error state.
+ */
+LABPACK_API bool labpack_keyset_is_error(labpack_keyset_t* keyset);
+
+/**
+ * Gets the number of names in the key set.
+ */
+LABPACK_API uint32_t labpack_keyset_count(labpack_keyset_t* keyset);
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup schema Schema API
+ *
+ * Record layouts for decoding maps directly into structs.
+ *
+ * @{
+ */
+
+/**
+ * Creates a schema from an array of <code>count</code> field descriptions.
+ *
+ * The fields are copied and their names are compiled into a key set, so the
+ * array does not need to outlive the schema. A schema can be used to read any
+ * number of records with the <code>labpack_read_record</code> function.
+ *
+ * A LABPACK_STATUS_ERROR_NULL_VALUE error occurs if the <code>fields</code>
+ * or any name is NULL, and a LABPACK_STATUS_ERROR_INVALID_ARGUMENT error
+ * occurs if a name appears more than once or a field has an unsupported type
+ * or size.
+ */
+LABPACK_API labpack_schema_t* labpack_schema_create(const labpack_field_t* fields, uint32_t count);
+
+/**
+ * Destroys a schema.
+ */
+LABPACK_API void labpack_schema_destroy(labpack_schema_t* schema);
+
+/**
+ * Gets the status of the schema.
+ */
+LABPACK_API labpack_status_t labpack_schema_status(labpack_schema_t* schema);
+
+/**
+ * Gets the status message of the schema.
+ */
+LABPACK_API const char* labpack_schema_status_message(labpack_schema_t* schema);
+
+/**
+ * Checks if the schema is OK.
+ */
+LABPACK_API bool labpack_schema_is_ok(labpack_schema_t* schema);
+
+/**
+ * Checks if the schema is in an error state.
+ */
+LABPACK_API bool labpack_schema_is_error(labpack_schema_t* schema);
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup validator Validate API
+ *
+ * Checks MessagePack data without decoding it.
+ *
+ * @{
+ */
+
+/**
+ * Checks that the data is exactly one well-formed MessagePack object.
+ *
+ * The data is walked in a single pass without allocating memory or decoding
+ * any values, which makes this much cheaper than reading the data with a
+ * reader. It is intended for rejecting malformed or hostile input before it
+ * is decoded.
+ *
+ * An error status is returned if a reserved (invalid) type byte is found, a
+ * value or container is truncated, maps and arrays are nested deeper than
+ * <code>max_depth</code>, or there are bytes after the end of the object. A
+ * <code>max_depth</code> of zero (0) only allows a single scalar value, and
+ * values greater than <code>LABPACK_MAX_DEPTH</code> are limited to
+ * <code>LABPACK_MAX_DEPTH</code>. Strings are not checked for valid UTF-8.
+ *
+ * Returns <code>LABPACK_STATUS_OK</code> if the data is valid,
+ * <code>LABPACK_STATUS_ERROR_DECODER</code> if it is not, or
+ * <code>LABPACK_STATUS_ERROR_NULL_VALUE</code> if the <code>data</code> is
+ * NULL but the <code>size</code> is greater than zero (0). The byte offset of
+ * the element that caused the error is stored in <code>error_offset</code>,
+ * which may be NULL if the offset is not needed.
+ */
+LABPACK_API labpack_status_t labpack_validate(const char* data, size_t size, uint32_t max_depth, size_t* error_offset);
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup parallel Parallel Decode API
+ *
+ * Decodes many back-to-back MessagePack messages on multiple threads.
+ *
+ * @{
+ */
+
+/**
+ * Decodes one message on a worker thread.
+ *
+ * The <code>reader</code> has already been begun over exactly one message and
+ * is ended after the function returns, so it should only be used to read the
+ * message. The <code>index</code> is the zero-based position of the message
+ * in the data. The returned value is passed to the deliver function.
+ *
+ * This is called concurrently from multiple threads, so any shared state
+ * reached through the <code>context</code> must be thread-safe.
+ */
+typedef void* (*labpack_message_decode_t)(labpack_reader_t* reader, uint64_t index, void* context);
+
+/**
+ * Receives the result of decoding one message.
+ *
+ * Results are delivered on the thread that started the decoding, one at a
+ * time and in message order. The <code>status</code> is the status of the
+ * message's reader after it was ended.
+ */
+typedef void (*labpack_message_deliver_t)(uint64_t index, labpack_status_t status, void* result, void* context);
+
+/**
+ * Decodes back-to-back MessagePack messages using a pool of worker threads.
+ *
+ * The calling thread splits the data at message boundaries with a fast,
+ * skip-only pass, as done by the <code>labpack_validate</code> function, and
+ * hands batches of messages to <code>threads</code> worker threads, each
+ * with its own reader. The <code>decode</code> function is called for every
+ * message on a worker thread, and the <code>deliver</code> function, which may
+ * be NULL, is called in message order on the calling thread. A
+ * <code>threads</code> count of zero (0) uses one thread per processor.
+ * Memory use is bounded by the number of threads, not the size of the data.
+ *
+ * Returns <code>LABPACK_STATUS_OK</code> once all messages have been
+ * delivered. If malformed or truncated data is found while splitting, the
+ * complete messages before it are still decoded and delivered, and then
+ * <code>LABPACK_STATUS_ERROR_DECODER</code> is returned. Errors while
+ * decoding an individual message are reported through the status passed to
+ * the deliver function. A LABPACK_STATUS_ERROR_NULL_VALUE error is returned
+ * if the <code>data</code> is NULL but the <code>size</code> is greater than
+ * zero (0), or the <code>decode</code> function is NULL.
+ */
+LABPACK_API labpack_status_t labpack_decode_parallel(const char* data, size_t size, uint32_t threads, labpack_message_decode_t decode, labpack_message_deliver_t deliver, void* context);
+
+/**
+ * Decodes back-to-back MessagePack messages in a file using a pool of worker
+ * threads.
+ *
+ * The file is memory-mapped read-only, as done by the
+ * <code>labpack_reader_begin_file</code> function, and decoded with the
+ * <code>labpack_decode_parallel</code> function. A LABPACK_STATUS_ERROR_IO
+ * error is returned if the file cannot be opened or mapped.
+ */
+LABPACK_API labpack_status_t labpack_decode_parallel_file(const char* path, uint32_t threads, labpack_message_decode_t decode, labpack_message_deliver_t deliver, void* context);
+
 /**
  * @}
  */
@@ -138,10 +138,18 @@
  * set and @ref MPACK_REALLOC is not, @ref MPACK_MALLOC is used with a simple copy
  * to grow buffers.
  */
-#if defined(MPACK_STDLIB) && !defined(MPACK_MALLOC)
-#define MPACK_MALLOC malloc
-#define MPACK_REALLOC realloc
-#define MPACK_FREE free
+#if !defined(MPACK_MALLOC)
+/*
+ * labpack routes the allocations of MPack through the allocator set with
+ * labpack_set_allocator, which is the C heap by default.
+ */
+#include <stddef.h>
+void* labpack_mpack_malloc(size_t size);
+void* labpack_mpack_realloc(void* pointer, size_t size);
+void labpack_mpack_free(void* pointer);
+#define MPACK_MALLOC labpack_mpack_malloc
+#define MPACK_REALLOC labpack_mpack_realloc
+#define MPACK_FREE labpack_mpack_free
 #endif
 
 /**
@@ -0,0 +1,321 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "minunit.h"
+#include "labpack.h"
+
+#define LARGE_COUNT 100000
+
+static const char* ACTUAL_DOES_NOT_MATCH_EXPECTED = "The actual value does not match the expected value";
+static const char* UNEXPECTED_STATUS = "The status is not the expected status";
+
+typedef struct _counts {
+    uint64_t allocations;
+    uint64_t reallocations;
+    uint64_t releases;
+    int64_t live;
+} counts_t;
+
+static counts_t counts;
+static char* large = NULL;
+
+static void*
+counting_allocate(void* context, size_t size)
+{
+    counts_t* c = (counts_t*)context;
+    c->allocations += 1;
+    c->live += 1;
+    return malloc(size);
+}
+
+static void*
+counting_reallocate(void* context, void* pointer, size_t size)
+{
+    counts_t* c = (counts_t*)context;
+    c->reallocations += 1;
+    return realloc(pointer, size);
+}
+
+static void
+counting_release(void* context, void* pointer)
+{
+    counts_t* c = (counts_t*)context;
+    c->releases += 1;
+    c->live -= 1;
+    free(pointer);
+}
+
+static void*
+failing_allocate(void* context, size_t size)
+{
+    (void)context;
+    (void)size;
+    return NULL;
+}
+
+static const labpack_allocator_t COUNTING_ALLOCATOR = {
+    counting_allocate,
+    counting_reallocate,
+    counting_release,
+    &counts
+};
+
+static const labpack_allocator_t FAILING_ALLOCATOR = {
+    failing_allocate,
+    counting_reallocate,
+    counting_release,
+    &counts
+};
+
+static void
+setup()
+{
+    memset(&counts, 0, sizeof(counts));
+    large = calloc(LARGE_COUNT, 1);
+}
+
+static void
+teardown()
+{
+    labpack_set_allocator(NULL);
+    free(large);
+    large = NULL;
+}
+
+MU_TEST(test_writer_uses_allocator)
+{
+    labpack_writer_t* writer = labpack_writer_create_with_allocator(&COUNTING_ALLOCATOR);
+    mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    labpack_writer_begin(writer);
+    labpack_write_bin(writer, large, LARGE_COUNT);
+    labpack_writer_end(writer);
+    mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    labpack_stats_t stats;
+    labpack_writer_stats(writer, &stats);
+    mu_assert(counts.allocations > stats.allocations, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(counts.reallocations == stats.reallocations, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(counts.reallocations > 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_writer_destroy(writer);
+    mu_assert(counts.live == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(counts.releases == counts.allocations, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_writer_reuses_buffer_without_allocating)
+{
+    labpack_writer_t* writer = labpack_writer_create_with_allocator(&COUNTING_ALLOCATOR);
+    labpack_writer_begin(writer);
+    labpack_write_u32(writer, 42);
+    labpack_writer_end(writer);
+    uint64_t allocations = counts.allocations;
+    for (int i = 0; i < 100; i++) {
+        labpack_writer_begin(writer);
+        labpack_write_u32(writer, 42);
+        labpack_writer_end(writer);
+    }
+    mu_assert(counts.allocations == allocations, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(counts.reallocations == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_writer_destroy(writer);
+    mu_assert(counts.live == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_uses_allocator)
+{
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_writer_begin(writer);
+    labpack_write_bin(writer, large, LARGE_COUNT);
+    labpack_writer_end(writer);
+    size_t size = labpack_writer_buffer_size(writer);
+    char* data = malloc(size);
+    labpack_writer_buffer_data(writer, data);
+    labpack_writer_destroy(writer);
+    mu_assert(counts.allocations == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_t* reader = labpack_reader_create_with_allocator(&COUNTING_ALLOCATOR);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    labpack_reader_begin_incremental(reader);
+    labpack_reader_feed(reader, data, size / 2);
+    labpack_reader_feed(reader, data + size / 2, size - size / 2);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(counts.allocations > 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_destroy(reader);
+    free(data);
+    mu_assert(counts.live == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(counts.releases == counts.allocations, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_set_allocator_applies_to_new_handles)
+{
+    static const char* names[] = { "a", "b", "c" };
+    labpack_field_t fields[] = {
+        { "a", LABPACK_TYPE_UINT, 0, 4 }
+    };
+    labpack_set_allocator(&COUNTING_ALLOCATOR);
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_reader_t* reader = labpack_reader_create();
+    labpack_keyset_t* keyset = labpack_keyset_create(names, 3);
+    labpack_schema_t* schema = labpack_schema_create(fields, 1);
+    mu_assert(labpack_keyset_status(keyset) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(labpack_schema_status(schema) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(counts.live >= 6, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    // Handles keep the allocator they were created with
+    labpack_set_allocator(NULL);
+    int64_t live = counts.live;
+    labpack_writer_t* other = labpack_writer_create();
+    mu_assert(counts.live == live, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_writer_destroy(other);
+    labpack_schema_destroy(schema);
+    labpack_keyset_destroy(keyset);
+    labpack_reader_destroy(reader);
+    labpack_writer_destroy(writer);
+    mu_assert(counts.live == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_null_allocator_is_current_allocator)
+{
+    labpack_set_allocator(&COUNTING_ALLOCATOR);
+    labpack_writer_t* writer = labpack_writer_create_with_allocator(NULL);
+    mu_assert(counts.allocations > 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_writer_destroy(writer);
+    mu_assert(counts.live == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_failing_allocator_sets_out_of_memory)
+{
+    labpack_writer_t* writer = labpack_writer_create_with_allocator(&FAILING_ALLOCATOR);
+    labpack_reader_t* reader = labpack_reader_create_with_allocator(&FAILING_ALLOCATOR);
+    mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_ERROR_OUT_OF_MEMORY, UNEXPECTED_STATUS);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_OUT_OF_MEMORY, UNEXPECTED_STATUS);
+    labpack_writer_destroy(writer);
+    labpack_reader_destroy(reader);
+    mu_assert(counts.releases == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_allocated_bytes_are_counted)
+{
+    size_t before = labpack_allocated_bytes();
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_writer_begin(writer);
+    labpack_write_bin(writer, large, LARGE_COUNT);
+    labpack_writer_end(writer);
+    mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(labpack_allocated_bytes() >= before + LARGE_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_peak_allocated_bytes() >= labpack_allocated_bytes(), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_writer_destroy(writer);
+    mu_assert(labpack_allocated_bytes() == before, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reset_peak_allocated_bytes)
+{
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_writer_begin(writer);
+    labpack_write_bin(writer, large, LARGE_COUNT);
+    labpack_writer_end(writer);
+    labpack_writer_destroy(writer);
+    mu_assert(labpack_peak_allocated_bytes() >= labpack_allocated_bytes() + LARGE_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reset_peak_allocated_bytes();
+    mu_assert(labpack_peak_allocated_bytes() == labpack_allocated_bytes(), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_writer_footprint)
+{
+    labpack_footprint_t footprint;
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_writer_footprint(writer, &footprint);
+    mu_assert(footprint.buffer == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_writer_begin(writer);
+    labpack_write_bin(writer, large, LARGE_COUNT);
+    labpack_writer_end(writer);
+    labpack_writer_footprint(writer, &footprint);
+    mu_assert(footprint.buffer >= LARGE_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(footprint.peak_buffer == footprint.buffer, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(footprint.arena == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(footprint.mapped == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_writer_destroy(writer);
+}
+
+MU_TEST(test_reader_footprint)
+{
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_writer_begin(writer);
+    labpack_write_bin(writer, large, LARGE_COUNT);
+    labpack_writer_end(writer);
+    size_t size = labpack_writer_buffer_size(writer);
+    char* data = malloc(size);
+    labpack_writer_buffer_data(writer, data);
+    labpack_writer_destroy(writer);
+    labpack_footprint_t footprint;
+    labpack_reader_t* reader = labpack_reader_create();
+    labpack_reader_set_arena(reader, 4096);
+    labpack_reader_set_arena(reader, 64);
+    labpack_reader_begin_incremental(reader);
+    labpack_reader_feed(reader, data, size);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    labpack_reader_footprint(reader, &footprint);
+    mu_assert(footprint.buffer >= size, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(footprint.peak_buffer == footprint.buffer, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(footprint.arena == 64, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(footprint.peak_arena == 4096, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(footprint.mapped == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_destroy(reader);
+    free(data);
+}
+
+MU_TEST_SUITE(allocator)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_writer_uses_allocator);
+    MU_RUN_TEST(test_writer_reuses_buffer_without_allocating);
+    MU_RUN_TEST(test_reader_uses_allocator);
+    MU_RUN_TEST(test_set_allocator_applies_to_new_handles);
+    MU_RUN_TEST(test_null_allocator_is_current_allocator);
+    MU_RUN_TEST(test_failing_allocator_sets_out_of_memory);
+    MU_RUN_TEST(test_allocated_bytes_are_counted);
+    MU_RUN_TEST(test_reset_peak_allocated_bytes);
+    MU_RUN_TEST(test_writer_footprint);
+    MU_RUN_TEST(test_reader_footprint);
+}
+
+int 
+main(int argc, char* argv[]) 
+{
+    MU_RUN_SUITE(allocator);
+    MU_REPORT();
+    return minunit_fail;
+}
@@ -0,0 +1,307 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "minunit.h"
+#include "labpack.h"
+
+#define MANY_NAMES_COUNT 1000
+
+static const char* ACTUAL_DOES_NOT_MATCH_EXPECTED = "The actual value does not match the expected value";
+static const char* UNEXPECTED_STATUS = "The status is not the expected status";
+
+static const char* NAMES[] = {
+    "timestamp",
+    "channel",
+    "value",
+    "units",
+    "status",
+    "",
+    "a"
+};
+static const uint32_t NAMES_COUNT = sizeof(NAMES) / sizeof(NAMES[0]);
+
+static labpack_keyset_t* keyset = NULL;
+static labpack_reader_t* reader = NULL;
+static labpack_writer_t* writer = NULL;
+
+static void
+setup()
+{
+    keyset = labpack_keyset_create(NAMES, NAMES_COUNT);
+    reader = labpack_reader_create();
+    writer = labpack_writer_create();
+}
+
+static void
+teardown()
+{
+    labpack_keyset_destroy(keyset);
+    keyset = NULL;
+    labpack_reader_destroy(reader);
+    reader = NULL;
+    labpack_writer_destroy(writer);
+    writer = NULL;
+}
+
+static char*
+encode_keys(const char** keys, uint32_t count, size_t* size)
+{
+    labpack_writer_begin(writer);
+    for (uint32_t i = 0; i < count; i++) {
+        labpack_write_cstr(writer, keys[i]);
+    }
+    labpack_writer_end(writer);
+    *size = labpack_writer_buffer_size(writer);
+    char* data = malloc(*size);
+    labpack_writer_buffer_data(writer, data);
+    return data;
+}
+
+MU_TEST(test_keyset_create_works)
+{
+    mu_assert(labpack_keyset_is_ok(keyset), "Failed to create key set");
+    mu_assert(labpack_keyset_count(keyset) == NAMES_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_keyset_create_works_with_empty_names)
+{
+    labpack_keyset_t* empty = labpack_keyset_create(NULL, 0);
+    mu_assert(labpack_keyset_is_ok(empty), "Failed to create key set");
+    labpack_reader_begin(reader, "\xa1\x61", 2);
+    int32_t actual = labpack_reader_expect_key(reader, empty);
+    labpack_reader_end(reader);
+    labpack_keyset_destroy(empty);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(actual == -1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_keyset_create_errors_with_null_names)
+{
+    labpack_keyset_t* invalid = labpack_keyset_create(NULL, 2);
+    labpack_status_t status = labpack_keyset_status(invalid);
+    labpack_keyset_destroy(invalid);
+    mu_assert(status == LABPACK_STATUS_ERROR_NULL_VALUE, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_keyset_create_errors_with_null_name)
+{
+    const char* names[] = { "a", NULL };
+    labpack_keyset_t* invalid = labpack_keyset_create(names, 2);
+    labpack_status_t status = labpack_keyset_status(invalid);
+    labpack_keyset_destroy(invalid);
+    mu_assert(status == LABPACK_STATUS_ERROR_NULL_VALUE, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_keyset_create_errors_with_duplicate_names)
+{
+    const char* names[] = { "a", "b", "c", "b" };
+    labpack_keyset_t* invalid = labpack_keyset_create(names, 4);
+    labpack_status_t status = labpack_keyset_status(invalid);
+    labpack_keyset_destroy(invalid);
+    mu_assert(status == LABPACK_STATUS_ERROR_INVALID_ARGUMENT, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_reader_expect_key_works)
+{
+    size_t size = 0;
+    char* data = encode_keys(NAMES, NAMES_COUNT, &size);
+    labpack_reader_begin(reader, data, size);
+    for (uint32_t i = 0; i < NAMES_COUNT; i++) {
+        int32_t actual = labpack_reader_expect_key(reader, keyset);
+        mu_assert(actual == (int32_t)i, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    }
+    labpack_reader_end(reader);
+    free(data);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+}
+
+MU_TEST(test_reader_expect_key_works_with_unknown_keys)
+{
+    const char* keys[] = { "time", "timestamps", "b", "a long key that is longer than every name", "value" };
+    size_t size = 0;
+    char* data = encode_keys(keys, 5, &size);
+    labpack_reader_begin(reader, data, size);
+    mu_assert(labpack_reader_expect_key(reader, keyset) == -1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_expect_key(reader, keyset) == -1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_expect_key(reader, keyset) == -1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_expect_key(reader, keyset) == -1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_is_ok(reader), "Reader is not OK after unknown keys");
+    mu_assert(labpack_reader_expect_key(reader, keyset) == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+    free(data);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+}
+
+MU_TEST(test_reader_expect_key_works_with_many_names)
+{
+    static char storage[MANY_NAMES_COUNT][16];
+    const char* names[MANY_NAMES_COUNT];
+    for (uint32_t i = 0; i < MANY_NAMES_COUNT; i++) {
+        snprintf(storage[i], sizeof(storage[i]), "field_%u", i);
+        names[i] = storage[i];
+    }
+    labpack_keyset_t* many = labpack_keyset_create(names, MANY_NAMES_COUNT);
+    mu_assert(labpack_keyset_is_ok(many), "Failed to create key set");
+    size_t size = 0;
+    char* data = encode_keys(names, MANY_NAMES_COUNT, &size);
+    uint32_t mismatches = 0;
+    for (uint32_t i = MANY_NAMES_COUNT; i > 0; i--) {
+        labpack_reader_begin(reader, data, size);
+        labpack_reader_skip(reader, i - 1);
+        if (labpack_reader_expect_key(reader, many) != (int32_t)(i - 1)) {
+            mismatches += 1;
+        }
+        labpack_reader_end(reader);
+    }
+    free(data);
+    labpack_keyset_destroy(many);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(mismatches == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_expect_key_works_with_record)
+{
+    labpack_writer_begin(writer);
+    labpack_writer_begin_map(writer, 3);
+    labpack_write_cstr(writer, "value");
+    labpack_write_double(writer, 1.5);
+    labpack_write_cstr(writer, "comment");
+    labpack_write_cstr(writer, "ignored");
+    labpack_write_cstr(writer, "channel");
+    labpack_write_u8(writer, 4);
+    labpack_writer_end_map(writer);
+    labpack_writer_end(writer);
+    size_t size = labpack_writer_buffer_size(writer);
+    char* data = malloc(size);
+    labpack_writer_buffer_data(writer, data);
+    double value = 0.0;
+    uint8_t channel = 0;
+    labpack_reader_begin(reader, data, size);
+    uint32_t count = labpack_reader_begin_map(reader);
+    for (uint32_t i = 0; i < count; i++) {
+        switch (labpack_reader_expect_key(reader, keyset)) {
+            case 1: channel = labpack_read_u8(reader); break;
+            case 2: value = labpack_read_double(reader); break;
+            default: labpack_reader_skip(reader, 1); break;
+        }
+    }
+    labpack_reader_end_map(reader);
+    labpack_reader_end(reader);
+    free(data);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(value == 1.5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(channel == 4, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_expect_key_works_with_stream)
+{
+    const char* keys[] = { "status", "a long key that is longer than the stream buffer", "units" };
+    size_t size = 0;
+    char* data = encode_keys(keys, 3, &size);
+    FILE* file = tmpfile();
+    fwrite(data, 1, size, file);
+    rewind(file);
+    labpack_reader_begin_stdfile(reader, file, 32);
+    int32_t first = labpack_reader_expect_key(reader, keyset);
+    int32_t second = labpack_reader_expect_key(reader, keyset);
+    int32_t third = labpack_reader_expect_key(reader, keyset);
+    labpack_reader_end(reader);
+    fclose(file);
+    free(data);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(first == 4, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(second == -1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(third == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_expect_key_errors_with_non_string_key)
+{
+    labpack_reader_begin(reader, "\x01", 1);
+    int32_t actual = labpack_reader_expect_key(reader, keyset);
+    mu_assert(actual == -1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_expect_key_errors_with_invalid_keyset)
+{
+    const char* names[] = { "a", "a" };
+    labpack_keyset_t* invalid = labpack_keyset_create(names, 2);
+    labpack_reader_begin(reader, "\xa1\x61", 2);
+    int32_t actual = labpack_reader_expect_key(reader, invalid);
+    labpack_keyset_destroy(invalid);
+    mu_assert(actual == -1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_INVALID_ARGUMENT, UNEXPECTED_STATUS);
+    labpack_reader_end(reader);
+}
+
+MU_TEST_SUITE(keyset_create)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_keyset_create_works);
+    MU_RUN_TEST(test_keyset_create_works_with_empty_names);
+    MU_RUN_TEST(test_keyset_create_errors_with_null_names);
+    MU_RUN_TEST(test_keyset_create_errors_with_null_name);
+    MU_RUN_TEST(test_keyset_create_errors_with_duplicate_names);
+}
+
+MU_TEST_SUITE(reader_expect_key)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_reader_expect_key_works);
+    MU_RUN_TEST(test_reader_expect_key_works_with_unknown_keys);
+    MU_RUN_TEST(test_reader_expect_key_works_with_many_names);
+    MU_RUN_TEST(test_reader_expect_key_works_with_record);
+    MU_RUN_TEST(test_reader_expect_key_works_with_stream);
+    MU_RUN_TEST(test_reader_expect_key_errors_with_non_string_key);
+    MU_RUN_TEST(test_reader_expect_key_errors_with_invalid_keyset);
+}
+
+int 
+main(int argc, char* argv[]) 
+{
+    MU_RUN_SUITE(keyset_create);
+    MU_RUN_SUITE(reader_expect_key);
+    MU_REPORT();
+    return minunit_fail;
+}
+
@@ -0,0 +1,195 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "minunit.h"
+#include "labpack.h"
+
+#define MESSAGES_COUNT 100
+#define BOOLS_COUNT 64
+
+static const char* ACTUAL_DOES_NOT_MATCH_EXPECTED = "The actual value does not match the expected value";
+
+static labpack_reader_t* reader = NULL;
+static labpack_writer_t* writer = NULL;
+static uint64_t counts[LABPACK_LATENCY_BUCKETS];
+
+static void
+setup()
+{
+    reader = labpack_reader_create();
+    writer = labpack_writer_create();
+}
+
+static void
+teardown()
+{
+    labpack_reader_destroy(reader);
+    reader = NULL;
+    labpack_writer_destroy(writer);
+    writer = NULL;
+}
+
+static uint64_t
+sum_counts()
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < LABPACK_LATENCY_BUCKETS; i++) {
+        sum += counts[i];
+    }
+    return sum;
+}
+
+MU_TEST(test_latency_bucket_limit_works)
+{
+    mu_assert(labpack_latency_bucket_limit(0) == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_latency_bucket_limit(7) == 7, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_latency_bucket_limit(8) == 8, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_latency_bucket_limit(15) == 15, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_latency_bucket_limit(16) == 17, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_latency_bucket_limit(LABPACK_LATENCY_BUCKETS - 1) == UINT64_MAX, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    for (uint32_t i = 1; i < LABPACK_LATENCY_BUCKETS; i++) {
+        uint64_t lower = labpack_latency_bucket_limit(i - 1) + 1;
+        uint64_t upper = labpack_latency_bucket_limit(i);
+        mu_assert(upper >= lower, "The buckets are not increasing");
+        mu_assert(i < 16 || upper - lower < lower / 8 + 1, "A bucket is too wide");
+    }
+}
+
+MU_TEST(test_writer_latency_is_disabled_by_default)
+{
+    labpack_writer_begin(writer);
+    labpack_write_u8(writer, 1);
+    labpack_writer_end(writer);
+    counts[0] = 1;
+    uint64_t total = labpack_writer_latency_histogram(writer, LABPACK_LATENCY_MESSAGE, counts);
+    mu_assert(total == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(sum_counts() == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_writer_latency_percentile(writer, LABPACK_LATENCY_MESSAGE, 99.0) == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_writer_latency_records_messages)
+{
+    bool values[BOOLS_COUNT] = { false };
+    labpack_writer_set_latency(writer, true);
+    mu_assert(labpack_writer_is_ok(writer), "Failed to enable latency");
+    for (int i = 0; i < MESSAGES_COUNT; i++) {
+        labpack_writer_begin(writer);
+        labpack_write_bool_array(writer, values, BOOLS_COUNT);
+        labpack_writer_end(writer);
+    }
+    mu_assert(labpack_writer_is_ok(writer), "Failed to write messages");
+    uint64_t total = labpack_writer_latency_histogram(writer, LABPACK_LATENCY_MESSAGE, counts);
+    mu_assert(total == MESSAGES_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(sum_counts() == MESSAGES_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    total = labpack_writer_latency_histogram(writer, LABPACK_LATENCY_BULK, counts);
+    mu_assert(total == MESSAGES_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    uint64_t p50 = labpack_writer_latency_percentile(writer, LABPACK_LATENCY_MESSAGE, 50.0);
+    uint64_t p999 = labpack_writer_latency_percentile(writer, LABPACK_LATENCY_MESSAGE, 99.9);
+    uint64_t max = labpack_writer_latency_percentile(writer, LABPACK_LATENCY_MESSAGE, 100.0);
+    mu_assert(p50 > 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(p50 <= p999, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(p999 <= max, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_writer_set_latency_clears_histograms)
+{
+    labpack_writer_set_latency(writer, true);
+    labpack_writer_begin(writer);
+    labpack_writer_end(writer);
+    labpack_writer_set_latency(writer, true);
+    mu_assert(labpack_writer_latency_histogram(writer, LABPACK_LATENCY_MESSAGE, counts) == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_writer_begin(writer);
+    labpack_writer_end(writer);
+    labpack_writer_set_latency(writer, false);
+    mu_assert(labpack_writer_latency_histogram(writer, LABPACK_LATENCY_MESSAGE, counts) == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_latency_records_messages)
+{
+    // Back-to-back messages, each an array of three booleans
+    char data[MESSAGES_COUNT * 4];
+    for (int i = 0; i < MESSAGES_COUNT; i++) {
+        data[i * 4] = (char)0x93;
+        data[i * 4 + 1] = (char)0xc3;
+        data[i * 4 + 2] = (char)0xc2;
+        data[i * 4 + 3] = (char)0xc3;
+    }
+    bool values[3];
+    labpack_reader_set_latency(reader, true);
+    labpack_reader_begin(reader, data, sizeof(data));
+    while (labpack_reader_next_message(reader)) {
+        labpack_read_bool_array(reader, values, 3);
+    }
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to read messages");
+    uint64_t total = labpack_reader_latency_histogram(reader, LABPACK_LATENCY_MESSAGE, counts);
+    mu_assert(total == MESSAGES_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    total = labpack_reader_latency_histogram(reader, LABPACK_LATENCY_BULK, counts);
+    mu_assert(total == MESSAGES_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_latency_percentile(reader, LABPACK_LATENCY_BULK, 99.0) > 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_latency_records_single_message)
+{
+    labpack_reader_set_latency(reader, true);
+    labpack_reader_begin(reader, "\x01", 1);
+    labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_latency_histogram(reader, LABPACK_LATENCY_MESSAGE, counts) == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_latency_histogram(reader, LABPACK_LATENCY_BULK, counts) == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST_SUITE(latency)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_latency_bucket_limit_works);
+    MU_RUN_TEST(test_writer_latency_is_disabled_by_default);
+    MU_RUN_TEST(test_writer_latency_records_messages);
+    MU_RUN_TEST(test_writer_set_latency_clears_histograms);
+    MU_RUN_TEST(test_reader_latency_records_messages);
+    MU_RUN_TEST(test_reader_latency_records_single_message);
+}
+
+int 
+main(int argc, char* argv[]) 
+{
+    MU_RUN_SUITE(latency);
+    MU_REPORT();
+    return minunit_fail;
+}
@@ -0,0 +1,236 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "minunit.h"
+#include "labpack.h"
+
+#define MESSAGES_COUNT 5000
+
+static const char* ACTUAL_DOES_NOT_MATCH_EXPECTED = "The actual value does not match the expected value";
+static const char* UNEXPECTED_STATUS = "The status is not the expected status";
+static const char* TEST_FILE_PATH = "labpack-parallel-test.msgpack";
+
+typedef struct _results {
+    uint64_t count;
+    uint64_t errors;
+    bool in_order;
+} results_t;
+
+static char* data = NULL;
+static size_t size = 0;
+
+static void
+setup()
+{
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_writer_begin(writer);
+    for (uint32_t i = 0; i < MESSAGES_COUNT; i++) {
+        labpack_writer_begin_array(writer, 2);
+        labpack_write_u32(writer, i);
+        labpack_write_cstr(writer, "value");
+        labpack_writer_end_array(writer);
+    }
+    labpack_writer_end(writer);
+    size = labpack_writer_buffer_size(writer);
+    data = malloc(size);
+    labpack_writer_buffer_data(writer, data);
+    labpack_writer_destroy(writer);
+}
+
+static void
+teardown()
+{
+    free(data);
+    data = NULL;
+    size = 0;
+}
+
+static void*
+decode(labpack_reader_t* reader, uint64_t index, void* context)
+{
+    (void)index;
+    (void)context;
+    char value[5];
+    labpack_reader_begin_array(reader);
+    uint32_t number = labpack_read_u32(reader);
+    labpack_read_bytes(reader, value, labpack_reader_begin_str(reader));
+    labpack_reader_end_str(reader);
+    labpack_reader_end_array(reader);
+    return (void*)(uintptr_t)number;
+}
+
+static void
+deliver(uint64_t index, labpack_status_t status, void* result, void* context)
+{
+    results_t* results = (results_t*)context;
+    if (status != LABPACK_STATUS_OK) {
+        results->errors++;
+    } else if (index != results->count || (uintptr_t)result != index) {
+        results->in_order = false;
+    }
+    results->count++;
+}
+
+MU_TEST(test_decode_parallel_works)
+{
+    results_t results = {0, 0, true};
+    labpack_status_t status = labpack_decode_parallel(data, size, 4, decode, deliver, &results);
+    mu_assert(status == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(results.count == MESSAGES_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(results.errors == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(results.in_order, "The results were not delivered in order");
+}
+
+MU_TEST(test_decode_parallel_works_with_default_threads)
+{
+    results_t results = {0, 0, true};
+    labpack_status_t status = labpack_decode_parallel(data, size, 0, decode, deliver, &results);
+    mu_assert(status == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(results.count == MESSAGES_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(results.in_order, "The results were not delivered in order");
+}
+
+MU_TEST(test_decode_parallel_works_with_empty_data)
+{
+    results_t results = {0, 0, true};
+    labpack_status_t status = labpack_decode_parallel(NULL, 0, 2, decode, deliver, &results);
+    mu_assert(status == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(results.count == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_decode_parallel_works_without_deliver)
+{
+    labpack_status_t status = labpack_decode_parallel(data, size, 2, decode, NULL, NULL);
+    mu_assert(status == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_decode_parallel_reports_message_errors)
+{
+    results_t results = {0, 0, true};
+    labpack_status_t status = labpack_decode_parallel("\x92\x01\xa1\x61\xc0\x92\x02\xa1\x62", 9, 2, decode, deliver, &results);
+    mu_assert(status == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(results.count == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(results.errors == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_decode_parallel_reports_message_errors_across_batches)
+{
+    // The failing message is the last of the first batch, so the messages
+    // of every later batch are decoded by a reader left in an error state.
+    labpack_writer_t* writer = labpack_writer_create();
+    labpack_writer_begin(writer);
+    for (uint32_t i = 0; i < 1000; i++) {
+        if (i == 255) {
+            labpack_write_nil(writer);
+            continue;
+        }
+        labpack_writer_begin_array(writer, 2);
+        labpack_write_u32(writer, i);
+        labpack_write_cstr(writer, "value");
+        labpack_writer_end_array(writer);
+    }
+    labpack_writer_end(writer);
+    size_t messages_size = labpack_writer_buffer_size(writer);
+    char* messages = malloc(messages_size);
+    labpack_writer_buffer_data(writer, messages);
+    labpack_writer_destroy(writer);
+    results_t results = {0, 0, true};
+    labpack_status_t status = labpack_decode_parallel(messages, messages_size, 1, decode, deliver, &results);
+    free(messages);
+    mu_assert(status == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(results.count == 1000, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(results.errors == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_decode_parallel_errors_with_truncated_data)
+{
+    results_t results = {0, 0, true};
+    labpack_status_t status = labpack_decode_parallel(data, size - 1, 3, decode, deliver, &results);
+    mu_assert(status == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(results.count == MESSAGES_COUNT - 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(results.in_order, "The results were not delivered in order");
+}
+
+MU_TEST(test_decode_parallel_errors_with_null_decode)
+{
+    labpack_status_t status = labpack_decode_parallel(data, size, 2, NULL, deliver, NULL);
+    mu_assert(status == LABPACK_STATUS_ERROR_NULL_VALUE, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_decode_parallel_file_works)
+{
+    results_t results = {0, 0, true};
+    FILE* file = fopen(TEST_FILE_PATH, "wb");
+    fwrite(data, 1, size, file);
+    fclose(file);
+    labpack_status_t status = labpack_decode_parallel_file(TEST_FILE_PATH, 2, decode, deliver, &results);
+    remove(TEST_FILE_PATH);
+    mu_assert(status == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(results.count == MESSAGES_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(results.in_order, "The results were not delivered in order");
+}
+
+MU_TEST(test_decode_parallel_file_errors_with_missing_file)
+{
+    labpack_status_t status = labpack_decode_parallel_file("labpack-parallel-test-missing.msgpack", 2, decode, deliver, NULL);
+    mu_assert(status == LABPACK_STATUS_ERROR_IO, UNEXPECTED_STATUS);
+}
+
+MU_TEST_SUITE(decode_parallel)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_decode_parallel_works);
+    MU_RUN_TEST(test_decode_parallel_works_with_default_threads);
+    MU_RUN_TEST(test_decode_parallel_works_with_empty_data);
+    MU_RUN_TEST(test_decode_parallel_works_without_deliver);
+    MU_RUN_TEST(test_decode_parallel_reports_message_errors);
+    MU_RUN_TEST(test_decode_parallel_reports_message_errors_across_batches);
+    MU_RUN_TEST(test_decode_parallel_errors_with_truncated_data);
+    MU_RUN_TEST(test_decode_parallel_errors_with_null_decode);
+    MU_RUN_TEST(test_decode_parallel_file_works);
+    MU_RUN_TEST(test_decode_parallel_file_errors_with_missing_file);
+}
+
+int 
+main(int argc, char* argv[]) 
+{
+    MU_RUN_SUITE(decode_parallel);
+    MU_REPORT();
+    return minunit_fail;
+}
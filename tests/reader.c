@@ -32,6 +32,9 @@
  *   Christopher R. Field <chris@fieldrndservices.com>
  */
 
+#include <stdio.h>
+#include <string.h>
+
 #include "minunit.h"
 #include "labpack.h"
 #include "private.h"
@@ -106,6 +109,23 @@ MU_TEST(test_reader_end_works)
     mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
 }
 
+MU_TEST(test_reader_end_errors_with_unfinished_array)
+{
+    labpack_reader_begin(reader, "\x91\x01", 2);
+    labpack_reader_begin_array(reader);
+    labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+}
+
+MU_TEST(test_reader_end_map_errors_without_begin)
+{
+    labpack_reader_begin(reader, MSGPACK_HOME_PAGE_EXAMPLE_OUTPUT, MSGPACK_HOME_PAGE_EXAMPLE_LENGTH);
+    labpack_reader_end_map(reader);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
 MU_TEST(test_read_u8_works)
 {
     const uint8_t EXPECTED = 1;
@@ -399,6 +419,1238 @@ MU_TEST(test_begin_and_end_ext_works)
     mu_assert(actual_type == EXPECTED_TYPE, ACTUAL_DOES_NOT_MATCH_EXPECTED);
 }
 
+static FILE*
+create_stream(const char* data, size_t count)
+{
+    FILE* file = tmpfile();
+    fwrite(data, 1, count, file);
+    rewind(file);
+    return file;
+}
+
+MU_TEST(test_reader_begin_stdfile_works)
+{
+    FILE* file = create_stream(MSGPACK_HOME_PAGE_EXAMPLE_OUTPUT, MSGPACK_HOME_PAGE_EXAMPLE_LENGTH);
+    labpack_reader_begin_stdfile(reader, file, 0);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to begin reader");
+    uint32_t count = labpack_reader_begin_map(reader);
+    mu_assert(count == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+    fclose(file);
+}
+
+MU_TEST(test_reader_begin_stdfile_works_with_small_buffer)
+{
+    const char EXPECTED[] = "\xda\x00\x40" "0123456789012345678901234567890123456789012345678901234567890123" "\x2a";
+    char actual[64];
+    FILE* file = create_stream(EXPECTED, sizeof(EXPECTED) - 1);
+    labpack_reader_begin_stdfile(reader, file, 1);
+    uint32_t length = labpack_reader_begin_str(reader);
+    labpack_read_bytes(reader, actual, length);
+    labpack_reader_end_str(reader);
+    uint8_t value = labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(length == 64, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(memcmp(actual, EXPECTED + 3, 64) == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(value == 42, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_begin_stdfile_works_with_multiple_messages)
+{
+    FILE* file = create_stream("\x01\x02\x03", 3);
+    labpack_reader_begin_stdfile(reader, file, 32);
+    uint8_t first = labpack_read_u8(reader);
+    uint8_t second = labpack_read_u8(reader);
+    uint8_t third = labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(first == 1 && second == 2 && third == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_begin_stdfile_errors_with_null_file)
+{
+    labpack_reader_begin_stdfile(reader, NULL, 0);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, "Reader status is not a null value error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_begin_stdfile_errors_with_end_of_file)
+{
+    FILE* file = create_stream("\x92\x01", 2);
+    labpack_reader_begin_stdfile(reader, file, 0);
+    labpack_reader_begin_array(reader);
+    labpack_read_u8(reader);
+    labpack_read_u8(reader);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+    fclose(file);
+}
+
+MU_TEST(test_reader_begin_fd_works)
+{
+    FILE* file = create_stream("\x92\xcd\x01\x00\xa1\x61", 6);
+    labpack_reader_begin_fd(reader, fileno(file), 32);
+    labpack_reader_begin_array(reader);
+    uint16_t value = labpack_read_u16(reader);
+    uint32_t length = labpack_reader_begin_str(reader);
+    char actual = 0;
+    labpack_read_bytes(reader, &actual, length);
+    labpack_reader_end_str(reader);
+    labpack_reader_end_array(reader);
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(value == 256, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(actual == 'a', ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_begin_fd_errors_with_invalid_fd)
+{
+    labpack_reader_begin_fd(reader, -1, 0);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, "Reader status is not a null value error");
+    labpack_reader_end(reader);
+}
+
+static const char* TEST_FILE_PATH = "labpack-reader-test.msgpack";
+
+static void
+create_file(const char* data, size_t count)
+{
+    FILE* file = fopen(TEST_FILE_PATH, "wb");
+    if (count > 0) {
+        fwrite(data, 1, count, file);
+    }
+    fclose(file);
+}
+
+MU_TEST(test_reader_begin_file_works)
+{
+    create_file(MSGPACK_HOME_PAGE_EXAMPLE_OUTPUT, MSGPACK_HOME_PAGE_EXAMPLE_LENGTH);
+    labpack_reader_begin_file(reader, TEST_FILE_PATH);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to begin reader");
+    uint32_t count = labpack_reader_begin_map(reader);
+    char key[7];
+    uint32_t length = labpack_reader_begin_str(reader);
+    labpack_read_bytes(reader, key, length);
+    labpack_reader_end_str(reader);
+    labpack_read_true(reader);
+    length = labpack_reader_begin_str(reader);
+    labpack_read_bytes(reader, key, length);
+    labpack_reader_end_str(reader);
+    uint8_t value = labpack_read_u8(reader);
+    labpack_reader_end_map(reader);
+    labpack_reader_end(reader);
+    remove(TEST_FILE_PATH);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(memcmp(key, "schema", 6) == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(value == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_begin_file_works_with_empty_file)
+{
+    create_file(NULL, 0);
+    labpack_reader_begin_file(reader, TEST_FILE_PATH);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to begin reader");
+    labpack_read_nil(reader);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+    remove(TEST_FILE_PATH);
+}
+
+MU_TEST(test_reader_begin_file_errors_with_null_path)
+{
+    labpack_reader_begin_file(reader, NULL);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, "Reader status is not a null value error");
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, "Reader status is not a null value error");
+}
+
+MU_TEST(test_reader_begin_file_errors_with_missing_file)
+{
+    labpack_reader_begin_file(reader, "labpack-reader-test-missing.msgpack");
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_IO, "Reader status is not an IO error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_next_message_works)
+{
+    const char DATA[] = "\x01\x92\x02\x03\xa1\x61";
+    uint64_t offsets[3];
+    uint32_t count = 0;
+    labpack_reader_begin(reader, DATA, sizeof(DATA) - 1);
+    while (labpack_reader_next_message(reader)) {
+        offsets[count] = labpack_reader_offset(reader);
+        switch (count) {
+            case 0: labpack_read_u8(reader); break;
+            case 1:
+                labpack_reader_begin_array(reader);
+                labpack_read_u8(reader);
+                labpack_read_u8(reader);
+                labpack_reader_end_array(reader);
+                break;
+            case 2: {
+                char value;
+                labpack_read_bytes(reader, &value, labpack_reader_begin_str(reader));
+                labpack_reader_end_str(reader);
+                break;
+            }
+        }
+        count++;
+    }
+    mu_assert(labpack_reader_offset(reader) == sizeof(DATA) - 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(offsets[0] == 0 && offsets[1] == 1 && offsets[2] == 4, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_next_message_works_with_empty_data)
+{
+    labpack_reader_begin(reader, "", 0);
+    mu_assert(!labpack_reader_next_message(reader), "There is unexpectedly another message");
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+}
+
+MU_TEST(test_reader_next_message_works_with_stream)
+{
+    FILE* file = create_stream("\x01\x02\x03", 3);
+    uint32_t sum = 0;
+    labpack_reader_begin_stdfile(reader, file, 1);
+    while (labpack_reader_next_message(reader)) {
+        sum += labpack_read_u8(reader);
+    }
+    mu_assert(labpack_reader_offset(reader) == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(sum == 6, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_next_message_stops_on_error)
+{
+    uint32_t count = 0;
+    labpack_reader_begin(reader, "\x01\xc0\x02", 3);
+    while (labpack_reader_next_message(reader)) {
+        labpack_read_u8(reader);
+        count++;
+    }
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_error(reader), "Reader is unexpectedly OK");
+    mu_assert(count == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_next_message_errors_with_unfinished_container)
+{
+    labpack_reader_begin(reader, "\x92\x01\x02\x03", 4);
+    mu_assert(labpack_reader_next_message(reader), "The first message was not found");
+    labpack_reader_begin_array(reader);
+    labpack_read_u8(reader);
+    mu_assert(!labpack_reader_next_message(reader), "A message was framed inside an open container");
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    mu_assert(!labpack_reader_next_message(reader), "A message was framed after an unbalanced message");
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_error(reader), "Reader is unexpectedly OK");
+}
+
+MU_TEST(test_reader_offset_works)
+{
+    labpack_reader_begin(reader, MSGPACK_HOME_PAGE_EXAMPLE_OUTPUT, MSGPACK_HOME_PAGE_EXAMPLE_LENGTH);
+    mu_assert(labpack_reader_offset(reader) == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_begin_map(reader);
+    mu_assert(labpack_reader_offset(reader) == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_peek_works)
+{
+    labpack_type_t type = LABPACK_TYPE_NIL;
+    uint32_t count = 0;
+    labpack_reader_begin(reader, MSGPACK_HOME_PAGE_EXAMPLE_OUTPUT, MSGPACK_HOME_PAGE_EXAMPLE_LENGTH);
+    labpack_reader_peek(reader, &type, &count);
+    mu_assert(type == LABPACK_TYPE_MAP, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(count == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_begin_map(reader) == 2, "The peeked element was consumed");
+    labpack_reader_peek(reader, &type, &count);
+    mu_assert(type == LABPACK_TYPE_STR, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(count == 7, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_skip(reader, 4);
+    labpack_reader_end_map(reader);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+}
+
+MU_TEST(test_reader_peek_works_with_scalars)
+{
+    const char DATA[] = "\xc0\xc3\xca\x00\x00\x00\x00\xcb\x00\x00\x00\x00\x00\x00\x00\x00\xff\x01";
+    const labpack_type_t EXPECTED[] = {LABPACK_TYPE_NIL, LABPACK_TYPE_BOOL, LABPACK_TYPE_FLOAT, LABPACK_TYPE_DOUBLE, LABPACK_TYPE_INT, LABPACK_TYPE_UINT};
+    labpack_type_t type = LABPACK_TYPE_MAP;
+    uint32_t count = 1;
+    labpack_reader_begin(reader, DATA, sizeof(DATA) - 1);
+    for (size_t i = 0; i < 6; i++) {
+        labpack_reader_peek(reader, &type, &count);
+        mu_assert(type == EXPECTED[i], ACTUAL_DOES_NOT_MATCH_EXPECTED);
+        mu_assert(count == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+        switch (type) {
+            case LABPACK_TYPE_NIL: labpack_read_nil(reader); break;
+            case LABPACK_TYPE_BOOL: labpack_read_bool(reader); break;
+            case LABPACK_TYPE_FLOAT: labpack_read_float_strict(reader); break;
+            case LABPACK_TYPE_DOUBLE: labpack_read_double_strict(reader); break;
+            case LABPACK_TYPE_INT: labpack_read_i8(reader); break;
+            default: labpack_read_u8(reader); break;
+        }
+    }
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+}
+
+MU_TEST(test_reader_peek_works_with_ext)
+{
+    labpack_type_t type = LABPACK_TYPE_NIL;
+    uint32_t length = 0;
+    labpack_reader_begin(reader, "\xd6\x01\x00\x00\x00\x00", 6);
+    labpack_reader_peek(reader, &type, NULL);
+    labpack_reader_peek(reader, NULL, &length);
+    labpack_reader_end(reader);
+    mu_assert(type == LABPACK_TYPE_EXT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(length == 4, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_peek_errors_at_end_of_data)
+{
+    labpack_type_t type = LABPACK_TYPE_MAP;
+    labpack_reader_begin(reader, "", 0);
+    labpack_reader_peek(reader, &type, NULL);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    mu_assert(type == LABPACK_TYPE_NIL, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_skip_works)
+{
+    labpack_reader_begin(reader, "\x01\x02\x03", 3);
+    labpack_reader_skip(reader, 2);
+    uint8_t actual = labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(actual == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_skip_works_with_nested_containers)
+{
+    // [{"a": [1, 2]}, bin(3)], 7
+    const char DATA[] = "\x92\x81\xa1\x61\x92\x01\x02\xc4\x03\x00\x01\x02\x07";
+    labpack_reader_begin(reader, DATA, sizeof(DATA) - 1);
+    labpack_reader_skip(reader, 1);
+    uint8_t actual = labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(actual == 7, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_skip_works_with_map_values)
+{
+    labpack_reader_begin(reader, MSGPACK_HOME_PAGE_EXAMPLE_OUTPUT, MSGPACK_HOME_PAGE_EXAMPLE_LENGTH);
+    labpack_reader_begin_map(reader);
+    labpack_reader_skip(reader, 3);
+    uint8_t actual = labpack_read_u8(reader);
+    labpack_reader_end_map(reader);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(actual == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_skip_works_with_stream)
+{
+    char data[1024 + 6];
+    data[0] = (char)0xc5;
+    data[1] = 0x04;
+    data[2] = 0x00;
+    memset(data + 3, 0x55, 1024);
+    data[1027] = (char)0xa1;
+    data[1028] = 0x61;
+    data[1029] = 0x09;
+    FILE* file = create_stream(data, sizeof(data));
+    labpack_reader_begin_stdfile(reader, file, 32);
+    labpack_reader_skip(reader, 2);
+    uint8_t actual = labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(actual == 9, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_skip_works_with_zero_count)
+{
+    labpack_reader_begin(reader, "\x05", 1);
+    labpack_reader_skip(reader, 0);
+    uint8_t actual = labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    mu_assert(actual == 5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_skip_errors_with_too_few_elements)
+{
+    labpack_reader_begin(reader, "\x01\x02", 2);
+    labpack_reader_skip(reader, 3);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_subreader_works)
+{
+    // [[1, 2], {"a": 3}, "xyz"]
+    const char DATA[] = "\x93\x92\x01\x02\x81\xa1\x61\x03\xa3\x78\x79\x7a";
+    labpack_reader_t* child = labpack_reader_create();
+    labpack_reader_begin(reader, DATA, sizeof(DATA) - 1);
+    uint32_t count = labpack_reader_begin_array(reader);
+    labpack_reader_subreader(reader, child);
+    mu_assert(labpack_reader_begin_array(child) == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    uint8_t first = labpack_read_u8(child);
+    uint8_t second = labpack_read_u8(child);
+    labpack_reader_end_array(child);
+    labpack_reader_end(child);
+    mu_assert(labpack_reader_is_ok(child), "Failed to end child reader");
+    mu_assert(labpack_reader_offset(child) == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_subreader(reader, child);
+    mu_assert(labpack_reader_begin_map(child) == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_skip(child, 1);
+    uint8_t third = labpack_read_u8(child);
+    labpack_reader_end_map(child);
+    labpack_reader_end(child);
+    mu_assert(labpack_reader_is_ok(child), "Failed to end child reader");
+    char text[4] = { 0 };
+    labpack_reader_begin_str(reader);
+    labpack_read_bytes(reader, text, 3);
+    labpack_reader_end_str(reader);
+    labpack_reader_end_array(reader);
+    labpack_reader_end(reader);
+    labpack_reader_destroy(child);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(first == 1 && second == 2 && third == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert_string_eq("xyz", text);
+}
+
+MU_TEST(test_reader_subreader_works_with_file)
+{
+    labpack_reader_t* children[2] = { labpack_reader_create(), labpack_reader_create() };
+    create_file("\x92\xa1\x61\x91\x05", 5);
+    labpack_reader_begin_file(reader, TEST_FILE_PATH);
+    labpack_reader_begin_array(reader);
+    labpack_reader_subreader(reader, children[0]);
+    labpack_reader_subreader(reader, children[1]);
+    labpack_reader_end_array(reader);
+    char text[2] = { 0 };
+    labpack_reader_begin_str(children[0]);
+    labpack_read_bytes(children[0], text, 1);
+    labpack_reader_end_str(children[0]);
+    labpack_reader_end(children[0]);
+    labpack_reader_begin_array(children[1]);
+    uint8_t actual = labpack_read_u8(children[1]);
+    labpack_reader_end_array(children[1]);
+    labpack_reader_end(children[1]);
+    labpack_reader_end(reader);
+    remove(TEST_FILE_PATH);
+    mu_assert(labpack_reader_is_ok(children[0]), "Failed to end child reader");
+    mu_assert(labpack_reader_is_ok(children[1]), "Failed to end child reader");
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    labpack_reader_destroy(children[0]);
+    labpack_reader_destroy(children[1]);
+    mu_assert_string_eq("a", text);
+    mu_assert(actual == 5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_subreader_errors_with_stream)
+{
+    labpack_reader_t* child = labpack_reader_create();
+    FILE* file = create_stream("\x91\x01", 2);
+    labpack_reader_begin_stdfile(reader, file, 0);
+    labpack_reader_subreader(reader, child);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_INVALID_ARGUMENT, "Reader status is not an invalid argument error");
+    mu_assert(labpack_reader_status(child) == LABPACK_STATUS_ERROR_INVALID_ARGUMENT, "Child status is not an invalid argument error");
+    labpack_reader_end(child);
+    labpack_reader_end(reader);
+    fclose(file);
+    labpack_reader_destroy(child);
+}
+
+MU_TEST(test_reader_subreader_errors_with_truncated_data)
+{
+    labpack_reader_t* child = labpack_reader_create();
+    labpack_reader_begin(reader, "\x92\x01", 2);
+    labpack_reader_subreader(reader, child);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    mu_assert(labpack_reader_status(child) == LABPACK_STATUS_ERROR_DECODER, "Child status is not a decoder error");
+    labpack_reader_end(child);
+    labpack_reader_end(reader);
+    labpack_reader_destroy(child);
+}
+
+#define BOOLS_COUNT 1000
+
+static size_t
+create_bools(char* data, uint32_t count)
+{
+    // An array 16 header followed by a pattern of true and false elements
+    data[0] = (char)0xdc;
+    data[1] = (char)(count >> 8);
+    data[2] = (char)count;
+    for (uint32_t i = 0; i < count; i++) {
+        data[3 + i] = (i % 3 == 0 || i % 7 == 0) ? (char)0xc3 : (char)0xc2;
+    }
+    return 3 + count;
+}
+
+MU_TEST(test_read_bool_array_works)
+{
+    char data[3 + BOOLS_COUNT];
+    size_t size = create_bools(data, BOOLS_COUNT);
+    bool values[BOOLS_COUNT + 1];
+    labpack_reader_begin(reader, data, size);
+    uint32_t count = labpack_read_bool_array(reader, values, BOOLS_COUNT + 1);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == BOOLS_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < BOOLS_COUNT; i++) {
+        mismatches += values[i] != (i % 3 == 0 || i % 7 == 0);
+    }
+    mu_assert(mismatches == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_bool_array_works_with_stream)
+{
+    char data[3 + BOOLS_COUNT];
+    size_t size = create_bools(data, BOOLS_COUNT);
+    bool values[BOOLS_COUNT];
+    FILE* file = create_stream(data, size);
+    labpack_reader_begin_stdfile(reader, file, 32);
+    uint32_t count = labpack_read_bool_array(reader, values, BOOLS_COUNT);
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == BOOLS_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < BOOLS_COUNT; i++) {
+        mismatches += values[i] != (i % 3 == 0 || i % 7 == 0);
+    }
+    mu_assert(mismatches == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_bool_array_works_with_empty_array)
+{
+    labpack_reader_begin(reader, "\x90", 1);
+    uint32_t count = labpack_read_bool_array(reader, NULL, 0);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_bool_array_errors_with_non_bool_element)
+{
+    char data[3 + BOOLS_COUNT];
+    size_t size = create_bools(data, BOOLS_COUNT);
+    data[3 + 500] = 0x01;
+    bool values[BOOLS_COUNT];
+    labpack_reader_begin(reader, data, size);
+    uint32_t count = labpack_read_bool_array(reader, values, BOOLS_COUNT);
+    mu_assert(count == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_bool_array_errors_with_small_capacity)
+{
+    char data[3 + BOOLS_COUNT];
+    size_t size = create_bools(data, BOOLS_COUNT);
+    bool values[BOOLS_COUNT];
+    labpack_reader_begin(reader, data, size);
+    labpack_read_bool_array(reader, values, BOOLS_COUNT - 1);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_bool_array_errors_with_null_values)
+{
+    labpack_reader_begin(reader, "\x91\xc3", 2);
+    labpack_read_bool_array(reader, NULL, 1);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, "Reader status is not a null value error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_bool_bitset_works)
+{
+    char data[3 + BOOLS_COUNT];
+    size_t size = create_bools(data, 37);
+    uint8_t bits[(BOOLS_COUNT + 7) / 8];
+    memset(bits, 0xff, sizeof(bits));
+    labpack_reader_begin(reader, data, size);
+    uint32_t count = labpack_read_bool_bitset(reader, bits, BOOLS_COUNT);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 37, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < 40; i++) {
+        bool expected = i < 37 && (i % 3 == 0 || i % 7 == 0);
+        mismatches += ((bits[i / 8] >> (i % 8)) & 1) != expected;
+    }
+    mu_assert(mismatches == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_bool_bitset_works_with_stream)
+{
+    char data[3 + BOOLS_COUNT];
+    size_t size = create_bools(data, BOOLS_COUNT);
+    uint8_t bits[(BOOLS_COUNT + 7) / 8];
+    FILE* file = create_stream(data, size);
+    labpack_reader_begin_stdfile(reader, file, 45);
+    uint32_t count = labpack_read_bool_bitset(reader, bits, BOOLS_COUNT);
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == BOOLS_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < BOOLS_COUNT; i++) {
+        mismatches += ((bits[i / 8] >> (i % 8)) & 1) != (i % 3 == 0 || i % 7 == 0);
+    }
+    mu_assert(mismatches == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_bool_bitset_errors_with_non_bool_element)
+{
+    char data[3 + BOOLS_COUNT];
+    size_t size = create_bools(data, BOOLS_COUNT);
+    data[3 + 999] = (char)0xc0;
+    uint8_t bits[(BOOLS_COUNT + 7) / 8];
+    labpack_reader_begin(reader, data, size);
+    labpack_read_bool_bitset(reader, bits, BOOLS_COUNT);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_str_into_works)
+{
+    char buffer[8];
+    uint32_t length = 0;
+    labpack_reader_begin(reader, "\xa5hello\x01", 7);
+    labpack_read_str_into(reader, buffer, sizeof(buffer), &length);
+    uint8_t next = labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(length == 5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!memcmp(buffer, "hello", 5), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(next == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_str_into_works_with_empty_string)
+{
+    uint32_t length = 1;
+    labpack_reader_begin(reader, "\xa0", 1);
+    labpack_read_str_into(reader, NULL, 0, &length);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(length == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_str_into_works_with_stream)
+{
+    char data[3 + 300];
+    char buffer[300];
+    uint32_t length = 0;
+    data[0] = (char)0xda;
+    data[1] = 0x01;
+    data[2] = 0x2c;
+    for (uint32_t i = 0; i < 300; i++) {
+        data[3 + i] = (char)('a' + i % 26);
+    }
+    FILE* file = create_stream(data, sizeof(data));
+    labpack_reader_begin_stdfile(reader, file, 32);
+    labpack_read_str_into(reader, buffer, sizeof(buffer), &length);
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(length == 300, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!memcmp(buffer, data + 3, 300), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_str_into_errors_with_small_capacity)
+{
+    char buffer[4] = { 0 };
+    uint32_t length = 0;
+    labpack_reader_begin(reader, "\xa5hello", 6);
+    labpack_read_str_into(reader, buffer, sizeof(buffer), &length);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    mu_assert(length == 5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(buffer[0] == 0, "The buffer was modified");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_str_into_errors_with_wrong_type)
+{
+    char buffer[4];
+    labpack_reader_begin(reader, "\xc4\x01\x00", 3);
+    labpack_read_str_into(reader, buffer, sizeof(buffer), NULL);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_str_into_errors_with_null_buffer)
+{
+    labpack_reader_begin(reader, "\xa1\x61", 2);
+    labpack_read_str_into(reader, NULL, 1, NULL);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, "Reader status is not a null value error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_bin_into_works)
+{
+    char buffer[EXAMPLE_BINARY_COUNT];
+    uint32_t length = 0;
+    labpack_reader_begin(reader, "\xc4\x04\x00\x01\x02\x03", 6);
+    labpack_read_bin_into(reader, buffer, sizeof(buffer), &length);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(length == EXAMPLE_BINARY_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!memcmp(buffer, EXAMPLE_BINARY, EXAMPLE_BINARY_COUNT), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_bin_into_errors_with_small_capacity)
+{
+    char buffer[2];
+    uint32_t length = 0;
+    labpack_reader_begin(reader, "\xc4\x04\x00\x01\x02\x03", 6);
+    labpack_read_bin_into(reader, buffer, sizeof(buffer), &length);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    mu_assert(length == EXAMPLE_BINARY_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_ext_into_works)
+{
+    char buffer[EXAMPLE_BINARY_COUNT];
+    uint32_t length = 0;
+    int8_t type = 0;
+    labpack_reader_begin(reader, "\xd6\x02\x00\x01\x02\x03", 6);
+    labpack_read_ext_into(reader, &type, buffer, sizeof(buffer), &length);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(type == EXAMPLE_EXT_TYPE, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(length == EXAMPLE_BINARY_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!memcmp(buffer, EXAMPLE_BINARY, EXAMPLE_BINARY_COUNT), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_incremental_works_byte_by_byte)
+{
+    const char data[] = "\x82\xa1\x61\x01\xa1\x62\x92\xcd\x01\x00\xc3";
+    size_t count = sizeof(data) - 1;
+    labpack_reader_begin_incremental(reader);
+    for (size_t i = 0; i < count - 1; i++) {
+        labpack_reader_feed(reader, data + i, 1);
+        mu_assert(!labpack_reader_next_message(reader), "A partial message was decoded");
+        mu_assert(labpack_reader_is_ok(reader), "Partial data is an error");
+    }
+    labpack_reader_feed(reader, data + count - 1, 1);
+    mu_assert(labpack_reader_next_message(reader), "The complete message was not found");
+    labpack_reader_begin_map(reader);
+    char key[2];
+    uint32_t length = 0;
+    labpack_read_str_into(reader, key, sizeof(key), &length);
+    uint8_t a = labpack_read_u8(reader);
+    labpack_read_str_into(reader, key, sizeof(key), &length);
+    labpack_reader_begin_array(reader);
+    uint16_t first = labpack_read_u16(reader);
+    bool second = labpack_read_bool(reader);
+    labpack_reader_end_array(reader);
+    labpack_reader_end_map(reader);
+    mu_assert(labpack_reader_offset(reader) == count, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!labpack_reader_next_message(reader), "A message was decoded without data");
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(a == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(key[0] == 'b', ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(first == 256, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(second, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_incremental_works_with_many_messages_in_one_fragment)
+{
+    labpack_reader_begin_incremental(reader);
+    labpack_reader_feed(reader, "\x01\x02\xa1", 3);
+    uint8_t values[3] = { 0 };
+    uint8_t count = 0;
+    while (labpack_reader_next_message(reader)) {
+        values[count++] = labpack_read_u8(reader);
+    }
+    mu_assert(labpack_reader_is_ok(reader), "Partial data is an error");
+    mu_assert(count == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_feed(reader, "\x61\x03", 2);
+    char buffer[1];
+    uint32_t length = 0;
+    mu_assert(labpack_reader_next_message(reader), "The split message was not found");
+    labpack_read_str_into(reader, buffer, sizeof(buffer), &length);
+    mu_assert(labpack_reader_next_message(reader), "The last message was not found");
+    values[count++] = labpack_read_u8(reader);
+    mu_assert(!labpack_reader_next_message(reader), "A message was decoded without data");
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(values[0] == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(values[1] == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(values[2] == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(buffer[0] == 'a', ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_incremental_works_with_split_string)
+{
+    char data[3 + 10000];
+    char* buffer = malloc(10000);
+    uint32_t length = 0;
+    data[0] = (char)0xda;
+    data[1] = 0x27;
+    data[2] = 0x10;
+    for (uint32_t i = 0; i < 10000; i++) {
+        data[3 + i] = (char)('a' + i % 26);
+    }
+    labpack_reader_begin_incremental(reader);
+    // The first fragment splits the header
+    size_t position = 0;
+    size_t fragment = 2;
+    while (position < sizeof(data)) {
+        mu_assert(!labpack_reader_next_message(reader), "A partial message was decoded");
+        if (fragment > sizeof(data) - position) {
+            fragment = sizeof(data) - position;
+        }
+        labpack_reader_feed(reader, data + position, fragment);
+        position += fragment;
+        fragment = 997;
+    }
+    mu_assert(labpack_reader_next_message(reader), "The complete message was not found");
+    labpack_read_str_into(reader, buffer, 10000, &length);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(length == 10000, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!memcmp(buffer, data + 3, 10000), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    free(buffer);
+}
+
+MU_TEST(test_reader_incremental_works_when_fed_during_a_message)
+{
+    char data[4096];
+    memset(data, 0x07, sizeof(data));
+    labpack_reader_begin_incremental(reader);
+    labpack_reader_feed(reader, "\x92\xa2hi\x05\x93", 6);
+    mu_assert(labpack_reader_next_message(reader), "The complete message was not found");
+    labpack_reader_begin_array(reader);
+    char buffer[2];
+    uint32_t length = 0;
+    labpack_read_str_into(reader, buffer, sizeof(buffer), &length);
+    // Grows the buffer while the first message is being read
+    for (int i = 0; i < 4; i++) {
+        labpack_reader_feed(reader, data, sizeof(data));
+    }
+    uint8_t value = labpack_read_u8(reader);
+    labpack_reader_end_array(reader);
+    mu_assert(labpack_reader_next_message(reader), "The next message was not found");
+    labpack_reader_begin_array(reader);
+    for (int i = 0; i < 3; i++) {
+        labpack_read_u8(reader);
+    }
+    labpack_reader_end_array(reader);
+    mu_assert(labpack_reader_offset(reader) == 9, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    uint32_t messages = 0;
+    while (labpack_reader_next_message(reader)) {
+        labpack_read_u8(reader);
+        messages++;
+    }
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(!memcmp(buffer, "hi", 2), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(value == 5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(messages == 4 * sizeof(data) - 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_incremental_errors_with_invalid_data)
+{
+    labpack_reader_begin_incremental(reader);
+    labpack_reader_feed(reader, "\x91\xc1", 2);
+    mu_assert(!labpack_reader_next_message(reader), "An invalid message was decoded");
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_incremental_errors_with_deep_nesting)
+{
+    char data[LABPACK_MAX_DEPTH + 1];
+    memset(data, 0x91, sizeof(data));
+    labpack_reader_begin_incremental(reader);
+    labpack_reader_feed(reader, data, sizeof(data));
+    mu_assert(!labpack_reader_next_message(reader), "An invalid message was decoded");
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_feed_errors_without_incremental_begin)
+{
+    labpack_reader_begin(reader, "\x01", 1);
+    labpack_reader_feed(reader, "\x02", 1);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_INVALID_ARGUMENT, "Reader status is not an invalid argument error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_feed_errors_with_null_data)
+{
+    labpack_reader_begin_incremental(reader);
+    labpack_reader_feed(reader, NULL, 1);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, "Reader status is not a null value error");
+    labpack_reader_end(reader);
+}
+
+#if defined(_WIN32) && !defined(_WIN64)
+#pragma pack(push, 1)
+#endif
+typedef struct {
+    int32_t dimension;
+    double elements[4];
+} lv_double_array_t;
+
+typedef struct {
+    int32_t dimension;
+    int16_t elements[4];
+} lv_i16_array_t;
+#if defined(_WIN32) && !defined(_WIN64)
+#pragma pack(pop)
+#endif
+
+MU_TEST(test_read_lv_array_double_works)
+{
+    lv_double_array_t array;
+    labpack_reader_begin(reader, "\x93\xcb\x3f\xf8\x00\x00\x00\x00\x00\x00\xca\x40\x20\x00\x00\x03", 16);
+    uint32_t count = labpack_read_lv_array_double(reader, (char*)&array, sizeof(array));
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.dimension == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.elements[0] == 1.5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.elements[1] == 2.5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.elements[2] == 3.0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_lv_array_size(sizeof(double), 4) == sizeof(array), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_lv_array_i16_works)
+{
+    lv_i16_array_t array;
+    labpack_reader_begin(reader, "\x94\x01\xff\xd1\x80\x00\xcd\x7f\xff", 9);
+    uint32_t count = labpack_read_lv_array_i16(reader, (char*)&array, sizeof(array));
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 4, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.dimension == 4, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.elements[0] == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.elements[1] == -1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.elements[2] == INT16_MIN, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.elements[3] == INT16_MAX, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_lv_array_size(sizeof(int16_t), 4) == sizeof(array), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_lv_array_u32_works_with_stream)
+{
+    char data[3 + 100 * 5];
+    char out[4 + 100 * sizeof(uint32_t)];
+    data[0] = (char)0xdc;
+    data[1] = 0x00;
+    data[2] = 0x64;
+    for (uint32_t i = 0; i < 100; i++) {
+        data[3 + i * 5] = (char)0xce;
+        data[4 + i * 5] = 0x00;
+        data[5 + i * 5] = 0x01;
+        data[6 + i * 5] = 0x00;
+        data[7 + i * 5] = (char)i;
+    }
+    FILE* file = create_stream(data, sizeof(data));
+    labpack_reader_begin_stdfile(reader, file, 32);
+    uint32_t count = labpack_read_lv_array_u32(reader, out, sizeof(out));
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 100, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    for (uint32_t i = 0; i < 100; i++) {
+        uint32_t value = 0;
+        memcpy(&value, out + 4 + i * sizeof(value), sizeof(value));
+        mu_assert(value == 0x10000 + i, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    }
+}
+
+MU_TEST(test_read_lv_array_double_works_with_ext)
+{
+    lv_double_array_t array;
+    labpack_reader_begin(reader, "\xc7\x10\x01\x3f\xf8\x00\x00\x00\x00\x00\x00\xc0\x04\x00\x00\x00\x00\x00\x00", 19);
+    uint32_t count = labpack_read_lv_array_double(reader, (char*)&array, sizeof(array));
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.dimension == 2, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.elements[0] == 1.5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(array.elements[1] == -2.5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_lv_array_works_with_empty_array)
+{
+    char out[8];
+    memset(out, 0xff, sizeof(out));
+    labpack_reader_begin(reader, "\x90", 1);
+    uint32_t count = labpack_read_lv_array_double(reader, out, labpack_lv_array_size(sizeof(double), 0));
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!memcmp(out, "\x00\x00\x00\x00", 4), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_lv_array_errors_with_small_capacity)
+{
+    lv_i16_array_t array;
+    labpack_reader_begin(reader, "\x95\x01\x02\x03\x04\x05", 6);
+    uint32_t count = labpack_read_lv_array_i16(reader, (char*)&array, sizeof(array));
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    mu_assert(count == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_lv_array_errors_with_out_of_range_element)
+{
+    lv_i16_array_t array;
+    labpack_reader_begin(reader, "\x92\x01\xcd\x9c\x40", 5);
+    labpack_read_lv_array_i16(reader, (char*)&array, sizeof(array));
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_lv_array_errors_with_partial_ext_element)
+{
+    char out[16];
+    labpack_reader_begin(reader, "\xd5\x01\x00\x00", 4);
+    labpack_read_lv_array_u32(reader, out, sizeof(out));
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_lv_array_errors_with_wrong_type)
+{
+    char out[16];
+    labpack_reader_begin(reader, "\x80", 1);
+    labpack_read_lv_array_u8(reader, out, sizeof(out));
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_lv_array_errors_with_null_out)
+{
+    labpack_reader_begin(reader, "\x91\x01", 2);
+    labpack_read_lv_array_i64(reader, NULL, 16);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, "Reader status is not a null value error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_reader_stats_works)
+{
+    labpack_stats_t stats;
+    labpack_reader_stats(reader, &stats);
+    mu_assert(stats.bytes == 0, "The bytes are not zero");
+    mu_assert(stats.elements == 0, "The elements are not zero");
+    char buffer[4];
+    uint32_t length = 0;
+    labpack_reader_begin(reader, "\x82\xa1\x61\x01\xa1\x62\x90", 7);
+    labpack_reader_begin_map(reader);
+    labpack_read_str_into(reader, buffer, sizeof(buffer), &length);
+    labpack_read_u8(reader);
+    labpack_reader_skip(reader, 2);
+    labpack_reader_end_map(reader);
+    labpack_reader_end(reader);
+    labpack_reader_stats(reader, &stats);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(stats.bytes == 7, "The bytes are not correct");
+    mu_assert(stats.elements == 5, "The elements are not correct");
+    mu_assert(stats.containers == 1, "The containers are not correct");
+    mu_assert(stats.allocations == 0, "The allocations are not correct");
+    mu_assert(stats.bytes_copied == 1, "The bytes copied are not correct");
+    mu_assert(stats.errors == 0, "The errors are not correct");
+}
+
+MU_TEST(test_reader_stats_counts_stream_buffer)
+{
+    labpack_stats_t stats;
+    for (int i = 0; i < 3; i++) {
+        FILE* file = create_stream("\x01", 1);
+        labpack_reader_begin_stdfile(reader, file, 64);
+        labpack_read_u8(reader);
+        labpack_reader_end(reader);
+        fclose(file);
+    }
+    labpack_reader_stats(reader, &stats);
+    mu_assert(stats.allocations == 1, "The stream buffer was allocated for each stream");
+    mu_assert(stats.reallocations == 0, "The stream buffer was reallocated for the same size");
+    mu_assert(stats.bytes == 3, "The bytes are not correct");
+    mu_assert(stats.elements == 3, "The elements are not correct");
+}
+
+MU_TEST(test_reader_stats_counts_errors)
+{
+    labpack_stats_t stats;
+    labpack_reader_begin(reader, "\x01", 1);
+    labpack_read_nil(reader);
+    labpack_reader_stats(reader, &stats);
+    mu_assert(stats.errors == 1, "The error was not counted");
+    labpack_reader_end(reader);
+    labpack_reader_begin(reader, "\x01", 1);
+    labpack_read_u8(reader);
+    labpack_reader_end(reader);
+    labpack_reader_stats(reader, &stats);
+    mu_assert(stats.errors == 1, "The cleared error was counted again");
+    mu_assert(stats.bytes == 1, "The bytes of data with an error were counted");
+}
+
+MU_TEST(test_read_str_arena_works)
+{
+    uint32_t length = 0;
+    labpack_reader_set_arena(reader, 64);
+    labpack_reader_begin(reader, "\x92\xa5hello\xa5world", 13);
+    labpack_reader_begin_array(reader);
+    const char* first = labpack_read_str_arena(reader, &length);
+    const char* second = labpack_read_str_arena(reader, NULL);
+    labpack_reader_end_array(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to read strings");
+    mu_assert(length == 5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert_string_eq("hello", first);
+    mu_assert_string_eq("world", second);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+}
+
+MU_TEST(test_read_str_arena_works_with_empty_string)
+{
+    uint32_t length = 1;
+    labpack_reader_set_arena(reader, 1);
+    labpack_reader_begin(reader, "\xa0", 1);
+    const char* value = labpack_read_str_arena(reader, &length);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(length == 0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert_string_eq("", value);
+}
+
+MU_TEST(test_read_str_arena_works_with_stream)
+{
+    char data[3 + 300];
+    data[0] = (char)0xda;
+    data[1] = 0x01;
+    data[2] = 0x2c;
+    for (uint32_t i = 0; i < 300; i++) {
+        data[3 + i] = (char)('a' + i % 26);
+    }
+    uint32_t length = 0;
+    FILE* file = create_stream(data, sizeof(data));
+    labpack_reader_set_arena(reader, 301);
+    labpack_reader_begin_stdfile(reader, file, 32);
+    const char* value = labpack_read_str_arena(reader, &length);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to read string");
+    mu_assert(length == 300, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!memcmp(value, data + 3, 300), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+    fclose(file);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+}
+
+MU_TEST(test_read_str_arena_is_reset_for_each_message)
+{
+    labpack_reader_set_arena(reader, 6);
+    for (int i = 0; i < 3; i++) {
+        labpack_reader_begin(reader, "\xa5hello", 6);
+        const char* value = labpack_read_str_arena(reader, NULL);
+        mu_assert_string_eq("hello", value);
+        labpack_reader_end(reader);
+        mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    }
+    labpack_reader_begin(reader, "\xa5hello\xa5world", 12);
+    labpack_read_str_arena(reader, NULL);
+    mu_assert(labpack_reader_next_message(reader), "Failed to find next message");
+    const char* value = labpack_read_str_arena(reader, NULL);
+    mu_assert_string_eq("world", value);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+}
+
+MU_TEST(test_read_str_arena_errors_when_full)
+{
+    labpack_reader_set_arena(reader, 8);
+    labpack_reader_begin(reader, "\xa5hello\xa5world", 12);
+    labpack_read_str_arena(reader, NULL);
+    const char* value = labpack_read_str_arena(reader, NULL);
+    mu_assert(value == NULL, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_OUT_OF_MEMORY, "Reader status is not an out of memory error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_str_arena_errors_without_arena)
+{
+    labpack_reader_begin(reader, "\xa0", 1);
+    const char* value = labpack_read_str_arena(reader, NULL);
+    mu_assert(value == NULL, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_OUT_OF_MEMORY, "Reader status is not an out of memory error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_str_arena_errors_with_wrong_type)
+{
+    labpack_reader_set_arena(reader, 8);
+    labpack_reader_begin(reader, "\x01", 1);
+    const char* value = labpack_read_str_arena(reader, NULL);
+    mu_assert(value == NULL, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, "Reader status is not a decoder error");
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_bin_arena_works)
+{
+    uint32_t length = 0;
+    labpack_reader_set_arena(reader, 3);
+    labpack_reader_begin(reader, "\xc4\x03\x00\x01\x02", 5);
+    const char* value = labpack_read_bin_arena(reader, &length);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(length == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!memcmp(value, "\x00\x01\x02", 3), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_ext_arena_works)
+{
+    int8_t type = 0;
+    uint32_t length = 0;
+    labpack_reader_set_arena(reader, 4);
+    labpack_reader_begin(reader, "\xd6\x07\x01\x02\x03\x04", 6);
+    const char* value = labpack_read_ext_arena(reader, &type, &length);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(type == 7, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(length == 4, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(!memcmp(value, "\x01\x02\x03\x04", 4), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_reader_set_arena_counts_allocation)
+{
+    labpack_stats_t stats;
+    labpack_reader_set_arena(reader, 16);
+    labpack_reader_set_arena(reader, 16);
+    labpack_reader_stats(reader, &stats);
+    mu_assert(stats.allocations == 1, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_set_arena(reader, 0);
+    labpack_reader_begin(reader, "\xa0", 1);
+    mu_assert(labpack_read_str_arena(reader, NULL) == NULL, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    labpack_reader_end(reader);
+}
+
 MU_TEST_SUITE(reader_create_and_destroy) 
 {
     MU_RUN_TEST(test_reader_sanity_check);
@@ -424,6 +1676,8 @@ MU_TEST_SUITE(reader_begin_and_end)
 
     MU_RUN_TEST(test_reader_begin_works);
     MU_RUN_TEST(test_reader_end_works);
+    MU_RUN_TEST(test_reader_end_errors_with_unfinished_array);
+    MU_RUN_TEST(test_reader_end_map_errors_without_begin);
 }
 
 MU_TEST_SUITE(basic_number_functions)
@@ -482,6 +1736,158 @@ MU_TEST_SUITE(binary_data_functions)
     MU_RUN_TEST(test_begin_and_end_ext_works);
 }
 
+MU_TEST_SUITE(reader_streams)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_reader_begin_stdfile_works);
+    MU_RUN_TEST(test_reader_begin_stdfile_works_with_small_buffer);
+    MU_RUN_TEST(test_reader_begin_stdfile_works_with_multiple_messages);
+    MU_RUN_TEST(test_reader_begin_stdfile_errors_with_null_file);
+    MU_RUN_TEST(test_reader_begin_stdfile_errors_with_end_of_file);
+    MU_RUN_TEST(test_reader_begin_fd_works);
+    MU_RUN_TEST(test_reader_begin_fd_errors_with_invalid_fd);
+}
+
+MU_TEST_SUITE(reader_files)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_reader_begin_file_works);
+    MU_RUN_TEST(test_reader_begin_file_works_with_empty_file);
+    MU_RUN_TEST(test_reader_begin_file_errors_with_null_path);
+    MU_RUN_TEST(test_reader_begin_file_errors_with_missing_file);
+}
+
+MU_TEST_SUITE(reader_messages)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_reader_next_message_works);
+    MU_RUN_TEST(test_reader_next_message_works_with_empty_data);
+    MU_RUN_TEST(test_reader_next_message_works_with_stream);
+    MU_RUN_TEST(test_reader_next_message_stops_on_error);
+    MU_RUN_TEST(test_reader_next_message_errors_with_unfinished_container);
+    MU_RUN_TEST(test_reader_offset_works);
+}
+
+MU_TEST_SUITE(reader_peek)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_reader_peek_works);
+    MU_RUN_TEST(test_reader_peek_works_with_scalars);
+    MU_RUN_TEST(test_reader_peek_works_with_ext);
+    MU_RUN_TEST(test_reader_peek_errors_at_end_of_data);
+}
+
+MU_TEST_SUITE(reader_skip)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_reader_skip_works);
+    MU_RUN_TEST(test_reader_skip_works_with_nested_containers);
+    MU_RUN_TEST(test_reader_skip_works_with_map_values);
+    MU_RUN_TEST(test_reader_skip_works_with_stream);
+    MU_RUN_TEST(test_reader_skip_works_with_zero_count);
+    MU_RUN_TEST(test_reader_skip_errors_with_too_few_elements);
+}
+
+MU_TEST_SUITE(reader_subreader)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_reader_subreader_works);
+    MU_RUN_TEST(test_reader_subreader_works_with_file);
+    MU_RUN_TEST(test_reader_subreader_errors_with_stream);
+    MU_RUN_TEST(test_reader_subreader_errors_with_truncated_data);
+}
+
+MU_TEST_SUITE(bool_arrays)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_read_bool_array_works);
+    MU_RUN_TEST(test_read_bool_array_works_with_stream);
+    MU_RUN_TEST(test_read_bool_array_works_with_empty_array);
+    MU_RUN_TEST(test_read_bool_array_errors_with_non_bool_element);
+    MU_RUN_TEST(test_read_bool_array_errors_with_small_capacity);
+    MU_RUN_TEST(test_read_bool_array_errors_with_null_values);
+    MU_RUN_TEST(test_read_bool_bitset_works);
+    MU_RUN_TEST(test_read_bool_bitset_works_with_stream);
+    MU_RUN_TEST(test_read_bool_bitset_errors_with_non_bool_element);
+}
+
+MU_TEST_SUITE(read_into)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_read_str_into_works);
+    MU_RUN_TEST(test_read_str_into_works_with_empty_string);
+    MU_RUN_TEST(test_read_str_into_works_with_stream);
+    MU_RUN_TEST(test_read_str_into_errors_with_small_capacity);
+    MU_RUN_TEST(test_read_str_into_errors_with_wrong_type);
+    MU_RUN_TEST(test_read_str_into_errors_with_null_buffer);
+    MU_RUN_TEST(test_read_bin_into_works);
+    MU_RUN_TEST(test_read_bin_into_errors_with_small_capacity);
+    MU_RUN_TEST(test_read_ext_into_works);
+}
+
+MU_TEST_SUITE(reader_incremental)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_reader_incremental_works_byte_by_byte);
+    MU_RUN_TEST(test_reader_incremental_works_with_many_messages_in_one_fragment);
+    MU_RUN_TEST(test_reader_incremental_works_with_split_string);
+    MU_RUN_TEST(test_reader_incremental_works_when_fed_during_a_message);
+    MU_RUN_TEST(test_reader_incremental_errors_with_invalid_data);
+    MU_RUN_TEST(test_reader_incremental_errors_with_deep_nesting);
+    MU_RUN_TEST(test_reader_feed_errors_without_incremental_begin);
+    MU_RUN_TEST(test_reader_feed_errors_with_null_data);
+}
+
+MU_TEST_SUITE(lv_arrays)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_read_lv_array_double_works);
+    MU_RUN_TEST(test_read_lv_array_i16_works);
+    MU_RUN_TEST(test_read_lv_array_u32_works_with_stream);
+    MU_RUN_TEST(test_read_lv_array_double_works_with_ext);
+    MU_RUN_TEST(test_read_lv_array_works_with_empty_array);
+    MU_RUN_TEST(test_read_lv_array_errors_with_small_capacity);
+    MU_RUN_TEST(test_read_lv_array_errors_with_out_of_range_element);
+    MU_RUN_TEST(test_read_lv_array_errors_with_partial_ext_element);
+    MU_RUN_TEST(test_read_lv_array_errors_with_wrong_type);
+    MU_RUN_TEST(test_read_lv_array_errors_with_null_out);
+}
+
+MU_TEST_SUITE(reader_stats)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_reader_stats_works);
+    MU_RUN_TEST(test_reader_stats_counts_stream_buffer);
+    MU_RUN_TEST(test_reader_stats_counts_errors);
+}
+
+MU_TEST_SUITE(reader_arena)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_read_str_arena_works);
+    MU_RUN_TEST(test_read_str_arena_works_with_empty_string);
+    MU_RUN_TEST(test_read_str_arena_works_with_stream);
+    MU_RUN_TEST(test_read_str_arena_is_reset_for_each_message);
+    MU_RUN_TEST(test_read_str_arena_errors_when_full);
+    MU_RUN_TEST(test_read_str_arena_errors_without_arena);
+    MU_RUN_TEST(test_read_str_arena_errors_with_wrong_type);
+    MU_RUN_TEST(test_read_bin_arena_works);
+    MU_RUN_TEST(test_read_ext_arena_works);
+    MU_RUN_TEST(test_reader_set_arena_counts_allocation);
+}
+
 int 
 main(int argc, char* argv[]) 
 {
@@ -493,6 +1899,18 @@ main(int argc, char* argv[])
     MU_RUN_SUITE(compound_types);
     MU_RUN_SUITE(string_functions);
     MU_RUN_SUITE(binary_data_functions);
+    MU_RUN_SUITE(reader_streams);
+    MU_RUN_SUITE(reader_files);
+    MU_RUN_SUITE(reader_messages);
+    MU_RUN_SUITE(reader_peek);
+    MU_RUN_SUITE(reader_skip);
+    MU_RUN_SUITE(reader_subreader);
+    MU_RUN_SUITE(bool_arrays);
+    MU_RUN_SUITE(read_into);
+    MU_RUN_SUITE(reader_incremental);
+    MU_RUN_SUITE(lv_arrays);
+    MU_RUN_SUITE(reader_stats);
+    MU_RUN_SUITE(reader_arena);
 	MU_REPORT();
 	return minunit_fail;
 }
@@ -0,0 +1,371 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "minunit.h"
+#include "labpack.h"
+
+static const char* ACTUAL_DOES_NOT_MATCH_EXPECTED = "The actual value does not match the expected value";
+static const char* UNEXPECTED_STATUS = "The status is not the expected status";
+
+typedef struct _record {
+    bool enabled;
+    int8_t offset;
+    int16_t gain;
+    int32_t samples;
+    int64_t timestamp;
+    uint8_t channel;
+    uint16_t port;
+    uint32_t flags;
+    uint64_t serial;
+    float ratio;
+    double value;
+    char units[8];
+} record_t;
+
+static const labpack_field_t FIELDS[] = {
+    { "enabled", LABPACK_TYPE_BOOL, offsetof(record_t, enabled), sizeof(bool) },
+    { "offset", LABPACK_TYPE_INT, offsetof(record_t, offset), sizeof(int8_t) },
+    { "gain", LABPACK_TYPE_INT, offsetof(record_t, gain), sizeof(int16_t) },
+    { "samples", LABPACK_TYPE_INT, offsetof(record_t, samples), sizeof(int32_t) },
+    { "timestamp", LABPACK_TYPE_INT, offsetof(record_t, timestamp), sizeof(int64_t) },
+    { "channel", LABPACK_TYPE_UINT, offsetof(record_t, channel), sizeof(uint8_t) },
+    { "port", LABPACK_TYPE_UINT, offsetof(record_t, port), sizeof(uint16_t) },
+    { "flags", LABPACK_TYPE_UINT, offsetof(record_t, flags), sizeof(uint32_t) },
+    { "serial", LABPACK_TYPE_UINT, offsetof(record_t, serial), sizeof(uint64_t) },
+    { "ratio", LABPACK_TYPE_FLOAT, offsetof(record_t, ratio), sizeof(float) },
+    { "value", LABPACK_TYPE_DOUBLE, offsetof(record_t, value), sizeof(double) },
+    { "units", LABPACK_TYPE_STR, offsetof(record_t, units), sizeof(((record_t*)0)->units) }
+};
+static const uint32_t FIELDS_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+static labpack_schema_t* schema = NULL;
+static labpack_reader_t* reader = NULL;
+static labpack_writer_t* writer = NULL;
+static char* data = NULL;
+static size_t size = 0;
+
+static void
+setup()
+{
+    schema = labpack_schema_create(FIELDS, FIELDS_COUNT);
+    reader = labpack_reader_create();
+    writer = labpack_writer_create();
+}
+
+static void
+teardown()
+{
+    labpack_schema_destroy(schema);
+    schema = NULL;
+    labpack_reader_destroy(reader);
+    reader = NULL;
+    labpack_writer_destroy(writer);
+    writer = NULL;
+    free(data);
+    data = NULL;
+    size = 0;
+}
+
+static void
+start(uint32_t count)
+{
+    labpack_writer_begin(writer);
+    labpack_writer_begin_map(writer, count);
+}
+
+static void
+finish()
+{
+    labpack_writer_end(writer);
+    size = labpack_writer_buffer_size(writer);
+    data = malloc(size);
+    labpack_writer_buffer_data(writer, data);
+}
+
+MU_TEST(test_schema_create_works)
+{
+    mu_assert(labpack_schema_is_ok(schema), "Failed to create schema");
+}
+
+MU_TEST(test_schema_create_errors_with_null_fields)
+{
+    labpack_schema_t* invalid = labpack_schema_create(NULL, 1);
+    labpack_status_t status = labpack_schema_status(invalid);
+    labpack_schema_destroy(invalid);
+    mu_assert(status == LABPACK_STATUS_ERROR_NULL_VALUE, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_schema_create_errors_with_unsupported_size)
+{
+    const labpack_field_t fields[] = {
+        { "value", LABPACK_TYPE_INT, 0, 3 }
+    };
+    labpack_schema_t* invalid = labpack_schema_create(fields, 1);
+    labpack_status_t status = labpack_schema_status(invalid);
+    labpack_schema_destroy(invalid);
+    mu_assert(status == LABPACK_STATUS_ERROR_INVALID_ARGUMENT, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_schema_create_errors_with_unsupported_type)
+{
+    const labpack_field_t fields[] = {
+        { "value", LABPACK_TYPE_MAP, 0, 8 }
+    };
+    labpack_schema_t* invalid = labpack_schema_create(fields, 1);
+    labpack_status_t status = labpack_schema_status(invalid);
+    labpack_schema_destroy(invalid);
+    mu_assert(status == LABPACK_STATUS_ERROR_INVALID_ARGUMENT, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_schema_create_errors_with_duplicate_names)
+{
+    const labpack_field_t fields[] = {
+        { "value", LABPACK_TYPE_DOUBLE, 0, 8 },
+        { "value", LABPACK_TYPE_DOUBLE, 8, 8 }
+    };
+    labpack_schema_t* invalid = labpack_schema_create(fields, 2);
+    labpack_status_t status = labpack_schema_status(invalid);
+    labpack_schema_destroy(invalid);
+    mu_assert(status == LABPACK_STATUS_ERROR_INVALID_ARGUMENT, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_read_record_works)
+{
+    start(14);
+    labpack_write_cstr(writer, "units");
+    labpack_write_cstr(writer, "volts");
+    labpack_write_cstr(writer, "serial");
+    labpack_write_u64(writer, UINT64_MAX);
+    labpack_write_cstr(writer, "comment");
+    labpack_writer_begin_array(writer, 2);
+    labpack_write_cstr(writer, "skipped");
+    labpack_write_nil(writer);
+    labpack_writer_end_array(writer);
+    labpack_write_cstr(writer, "value");
+    labpack_write_double(writer, 2.5);
+    labpack_write_cstr(writer, "enabled");
+    labpack_write_true(writer);
+    labpack_write_cstr(writer, "offset");
+    labpack_write_i8(writer, -8);
+    labpack_write_cstr(writer, "gain");
+    labpack_write_i16(writer, -300);
+    labpack_write_cstr(writer, "samples");
+    labpack_write_i32(writer, 100000);
+    labpack_write_cstr(writer, "timestamp");
+    labpack_write_i64(writer, -5000000000LL);
+    labpack_write_cstr(writer, "channel");
+    labpack_write_u8(writer, 7);
+    labpack_write_cstr(writer, "port");
+    labpack_write_u16(writer, 8080);
+    labpack_write_cstr(writer, "flags");
+    labpack_write_u32(writer, 0xdeadbeef);
+    labpack_write_cstr(writer, "ratio");
+    labpack_write_float(writer, 0.25f);
+    labpack_write_cstr(writer, "x");
+    labpack_write_u8(writer, 1);
+    labpack_writer_end_map(writer);
+    finish();
+    record_t record;
+    memset(&record, 0, sizeof(record));
+    labpack_reader_begin(reader, data, size);
+    labpack_read_record(reader, schema, &record);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(record.enabled, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.offset == -8, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.gain == -300, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.samples == 100000, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.timestamp == -5000000000LL, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.channel == 7, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.port == 8080, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.flags == 0xdeadbeef, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.serial == UINT64_MAX, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.ratio == 0.25f, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.value == 2.5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert_string_eq("volts", record.units);
+}
+
+MU_TEST(test_read_record_works_with_missing_fields)
+{
+    start(1);
+    labpack_write_cstr(writer, "channel");
+    labpack_write_u8(writer, 3);
+    labpack_writer_end_map(writer);
+    finish();
+    record_t record;
+    memset(&record, 0, sizeof(record));
+    record.value = -1.0;
+    strcpy(record.units, "amps");
+    labpack_reader_begin(reader, data, size);
+    labpack_read_record(reader, schema, &record);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(record.channel == 3, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(record.value == -1.0, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert_string_eq("amps", record.units);
+}
+
+MU_TEST(test_read_record_works_with_many_records)
+{
+    labpack_writer_begin(writer);
+    labpack_writer_begin_array(writer, 100);
+    for (uint32_t i = 0; i < 100; i++) {
+        labpack_writer_begin_map(writer, 2);
+        labpack_write_cstr(writer, "samples");
+        labpack_write_i32(writer, (int32_t)i);
+        labpack_write_cstr(writer, "value");
+        labpack_write_double(writer, i * 0.5);
+        labpack_writer_end_map(writer);
+    }
+    labpack_writer_end_array(writer);
+    finish();
+    record_t records[100];
+    memset(records, 0, sizeof(records));
+    labpack_reader_begin(reader, data, size);
+    uint32_t count = labpack_reader_begin_array(reader);
+    for (uint32_t i = 0; i < count; i++) {
+        labpack_read_record(reader, schema, &records[i]);
+    }
+    labpack_reader_end_array(reader);
+    labpack_reader_end(reader);
+    mu_assert(labpack_reader_is_ok(reader), "Failed to end reader");
+    mu_assert(count == 100, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(records[99].samples == 99, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(records[99].value == 49.5, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_read_record_errors_with_long_string)
+{
+    start(1);
+    labpack_write_cstr(writer, "units");
+    labpack_write_cstr(writer, "kilovolts");
+    labpack_writer_end_map(writer);
+    finish();
+    record_t record;
+    memset(&record, 0, sizeof(record));
+    labpack_reader_begin(reader, data, size);
+    labpack_read_record(reader, schema, &record);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_record_errors_with_mismatched_type)
+{
+    start(1);
+    labpack_write_cstr(writer, "channel");
+    labpack_write_cstr(writer, "seven");
+    labpack_writer_end_map(writer);
+    finish();
+    record_t record;
+    memset(&record, 0, sizeof(record));
+    labpack_reader_begin(reader, data, size);
+    labpack_read_record(reader, schema, &record);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_record_errors_with_out_of_range_value)
+{
+    start(1);
+    labpack_write_cstr(writer, "channel");
+    labpack_write_u16(writer, 256);
+    labpack_writer_end_map(writer);
+    finish();
+    record_t record;
+    memset(&record, 0, sizeof(record));
+    labpack_reader_begin(reader, data, size);
+    labpack_read_record(reader, schema, &record);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_record_errors_with_null_record)
+{
+    labpack_reader_begin(reader, "\x80", 1);
+    labpack_read_record(reader, schema, NULL);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, UNEXPECTED_STATUS);
+    labpack_reader_end(reader);
+}
+
+MU_TEST(test_read_record_errors_with_invalid_schema)
+{
+    labpack_schema_t* invalid = labpack_schema_create(NULL, 1);
+    record_t record;
+    labpack_reader_begin(reader, "\x80", 1);
+    labpack_read_record(reader, invalid, &record);
+    labpack_schema_destroy(invalid);
+    mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_ERROR_NULL_VALUE, UNEXPECTED_STATUS);
+    labpack_reader_end(reader);
+}
+
+MU_TEST_SUITE(schema_create)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_schema_create_works);
+    MU_RUN_TEST(test_schema_create_errors_with_null_fields);
+    MU_RUN_TEST(test_schema_create_errors_with_unsupported_size);
+    MU_RUN_TEST(test_schema_create_errors_with_unsupported_type);
+    MU_RUN_TEST(test_schema_create_errors_with_duplicate_names);
+}
+
+MU_TEST_SUITE(read_record)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_read_record_works);
+    MU_RUN_TEST(test_read_record_works_with_missing_fields);
+    MU_RUN_TEST(test_read_record_works_with_many_records);
+    MU_RUN_TEST(test_read_record_errors_with_long_string);
+    MU_RUN_TEST(test_read_record_errors_with_mismatched_type);
+    MU_RUN_TEST(test_read_record_errors_with_out_of_range_value);
+    MU_RUN_TEST(test_read_record_errors_with_null_record);
+    MU_RUN_TEST(test_read_record_errors_with_invalid_schema);
+}
+
+int 
+main(int argc, char* argv[]) 
+{
+    MU_RUN_SUITE(schema_create);
+    MU_RUN_SUITE(read_record);
+    MU_REPORT();
+    return minunit_fail;
+}
+
@@ -0,0 +1,245 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "minunit.h"
+#include "labpack.h"
+
+#define STRING_LENGTH 200
+#define ELEMENTS_COUNT 37
+
+static const char* ACTUAL_DOES_NOT_MATCH_EXPECTED = "The actual value does not match the expected value";
+static const char* UNEXPECTED_STATUS = "The status is not the expected status";
+
+// Positions around the widths of the kernels, where a byte is missed if a
+// kernel stops or resumes at the wrong place.
+static const size_t POSITIONS[] = { 0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 196 };
+
+static labpack_reader_t* reader = NULL;
+static labpack_writer_t* writer = NULL;
+static labpack_simd_t selected = LABPACK_SIMD_SCALAR;
+static char text[STRING_LENGTH];
+
+static void
+setup()
+{
+    reader = labpack_reader_create();
+    writer = labpack_writer_create();
+    selected = labpack_simd();
+    memset(text, 'a', sizeof(text));
+}
+
+static void
+teardown()
+{
+    labpack_set_simd(selected);
+    labpack_reader_destroy(reader);
+    reader = NULL;
+    labpack_writer_destroy(writer);
+    writer = NULL;
+}
+
+static labpack_status_t
+write_text(size_t length)
+{
+    labpack_writer_begin(writer);
+    labpack_write_utf8(writer, text, (uint32_t)length);
+    labpack_writer_end(writer);
+    return labpack_writer_status(writer);
+}
+
+static uint64_t
+element_value(uint32_t index)
+{
+    return UINT64_C(0x0102030405060708) + index * UINT64_C(0x1011121314151617);
+}
+
+/**
+ * Writes the elements as the big-endian payload of an extension type, which
+ * the LabVIEW array functions swap into native byte order.
+ */
+static void
+write_ext_elements(size_t size)
+{
+    char payload[ELEMENTS_COUNT * 8];
+    for (uint32_t i = 0; i < ELEMENTS_COUNT; i++) {
+        uint64_t value = element_value(i);
+        for (size_t b = 0; b < size; b++) {
+            payload[i * size + b] = (char)(value >> (8 * (size - 1 - b)));
+        }
+    }
+    labpack_writer_begin(writer);
+    labpack_write_ext(writer, 1, payload, (uint32_t)(ELEMENTS_COUNT * size));
+    labpack_writer_end(writer);
+}
+
+static bool
+elements_match(const char* elements, size_t size)
+{
+    for (uint32_t i = 0; i < ELEMENTS_COUNT; i++) {
+        uint64_t expected = element_value(i);
+        const char* element = elements + i * size;
+        switch (size) {
+            case 2: { uint16_t value; memcpy(&value, element, size); if (value != (uint16_t)expected) return false; break; }
+            case 4: { uint32_t value; memcpy(&value, element, size); if (value != (uint32_t)expected) return false; break; }
+            default: { uint64_t value; memcpy(&value, element, size); if (value != expected) return false; break; }
+        }
+    }
+    return true;
+}
+
+MU_TEST(test_scalar_is_always_supported)
+{
+    mu_assert(labpack_simd_is_supported(LABPACK_SIMD_SCALAR), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_set_simd(LABPACK_SIMD_SCALAR), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    mu_assert(labpack_simd() == LABPACK_SIMD_SCALAR, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+}
+
+MU_TEST(test_widest_supported_simd_is_selected)
+{
+    mu_assert(labpack_simd_is_supported(selected), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    for (int simd = selected + 1; simd <= LABPACK_SIMD_AVX512; simd++) {
+        mu_assert(!labpack_simd_is_supported((labpack_simd_t)simd), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+    }
+}
+
+MU_TEST(test_unsupported_simd_is_not_set)
+{
+    labpack_set_simd(LABPACK_SIMD_SCALAR);
+    for (int simd = LABPACK_SIMD_SCALAR; simd <= LABPACK_SIMD_AVX512; simd++) {
+        if (!labpack_simd_is_supported((labpack_simd_t)simd)) {
+            mu_assert(!labpack_set_simd((labpack_simd_t)simd), ACTUAL_DOES_NOT_MATCH_EXPECTED);
+            mu_assert(labpack_simd() == LABPACK_SIMD_SCALAR, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+        }
+    }
+}
+
+MU_TEST(test_write_utf8_accepts_valid_strings_with_every_simd)
+{
+    for (int simd = LABPACK_SIMD_SCALAR; simd <= LABPACK_SIMD_AVX512; simd++) {
+        if (!labpack_set_simd((labpack_simd_t)simd)) {
+            continue;
+        }
+        for (size_t length = 0; length <= STRING_LENGTH; length++) {
+            mu_assert(write_text(length) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+        }
+        for (size_t p = 0; p < sizeof(POSITIONS) / sizeof(POSITIONS[0]); p++) {
+            size_t position = POSITIONS[p];
+            // U+00E9 and U+1F600 split across the widths of the kernels
+            memcpy(text + position, "\xc3\xa9", 2);
+            mu_assert(write_text(STRING_LENGTH) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+            memcpy(text + position, "\xf0\x9f\x98\x80", 4);
+            mu_assert(write_text(STRING_LENGTH) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+            memset(text, 'a', sizeof(text));
+        }
+    }
+}
+
+MU_TEST(test_write_utf8_rejects_invalid_strings_with_every_simd)
+{
+    for (int simd = LABPACK_SIMD_SCALAR; simd <= LABPACK_SIMD_AVX512; simd++) {
+        if (!labpack_set_simd((labpack_simd_t)simd)) {
+            continue;
+        }
+        for (size_t p = 0; p < sizeof(POSITIONS) / sizeof(POSITIONS[0]); p++) {
+            size_t position = POSITIONS[p];
+            text[position] = '\xff';
+            mu_assert(write_text(STRING_LENGTH) == LABPACK_STATUS_ERROR_ENCODER, UNEXPECTED_STATUS);
+            // An overlong encoding of '/'
+            memcpy(text + position, "\xc0\xaf", 2);
+            mu_assert(write_text(STRING_LENGTH) == LABPACK_STATUS_ERROR_ENCODER, UNEXPECTED_STATUS);
+            // A truncated sequence at the end of the string
+            text[position] = '\xc3';
+            mu_assert(write_text(position + 1) == LABPACK_STATUS_ERROR_ENCODER, UNEXPECTED_STATUS);
+            memset(text, 'a', sizeof(text));
+        }
+    }
+}
+
+MU_TEST(test_read_lv_array_swaps_ext_elements_with_every_simd)
+{
+    static const size_t SIZES[] = { 2, 4, 8 };
+    for (int simd = LABPACK_SIMD_SCALAR; simd <= LABPACK_SIMD_AVX512; simd++) {
+        if (!labpack_set_simd((labpack_simd_t)simd)) {
+            continue;
+        }
+        for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+            size_t size = SIZES[s];
+            write_ext_elements(size);
+            mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+            size_t message_size = labpack_writer_buffer_size(writer);
+            char* message = malloc(message_size);
+            labpack_writer_buffer_data(writer, message);
+            size_t capacity = labpack_lv_array_size(size, ELEMENTS_COUNT);
+            char* out = malloc(capacity);
+            uint32_t count = 0;
+            labpack_reader_begin(reader, message, message_size);
+            switch (size) {
+                case 2: count = labpack_read_lv_array_u16(reader, out, capacity); break;
+                case 4: count = labpack_read_lv_array_u32(reader, out, capacity); break;
+                default: count = labpack_read_lv_array_u64(reader, out, capacity); break;
+            }
+            labpack_reader_end(reader);
+            mu_assert(labpack_reader_status(reader) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+            mu_assert(count == ELEMENTS_COUNT, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+            bool matches = elements_match(out + capacity - ELEMENTS_COUNT * size, size);
+            free(out);
+            free(message);
+            mu_assert(matches, ACTUAL_DOES_NOT_MATCH_EXPECTED);
+        }
+    }
+}
+
+MU_TEST_SUITE(simd)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_scalar_is_always_supported);
+    MU_RUN_TEST(test_widest_supported_simd_is_selected);
+    MU_RUN_TEST(test_unsupported_simd_is_not_set);
+    MU_RUN_TEST(test_write_utf8_accepts_valid_strings_with_every_simd);
+    MU_RUN_TEST(test_write_utf8_rejects_invalid_strings_with_every_simd);
+    MU_RUN_TEST(test_read_lv_array_swaps_ext_elements_with_every_simd);
+}
+
+int 
+main(int argc, char* argv[]) 
+{
+    MU_RUN_SUITE(simd);
+    MU_REPORT();
+    return minunit_fail;
+}
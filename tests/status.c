@@ -47,10 +47,38 @@ MU_TEST(test_status_string_works)
     mu_assert_string_eq("No Error", text);
 }
 
+MU_TEST(test_status_code_works_with_io_error)
+{
+    int code = labpack_status_code(LABPACK_STATUS_ERROR_IO);
+    mu_assert(code == -5, "Not expected value");
+}
+
+MU_TEST(test_status_string_works_with_io_error)
+{
+    const char* text = labpack_status_string(LABPACK_STATUS_ERROR_IO);
+    mu_assert_string_eq("IO Error", text);
+}
+
+MU_TEST(test_status_code_works_with_invalid_argument_error)
+{
+    int code = labpack_status_code(LABPACK_STATUS_ERROR_INVALID_ARGUMENT);
+    mu_assert(code == -6, "Not expected value");
+}
+
+MU_TEST(test_status_string_works_with_invalid_argument_error)
+{
+    const char* text = labpack_status_string(LABPACK_STATUS_ERROR_INVALID_ARGUMENT);
+    mu_assert_string_eq("Invalid Argument Error", text);
+}
+
 MU_TEST_SUITE(status)
 {
    MU_RUN_TEST(test_status_code_works);
    MU_RUN_TEST(test_status_string_works);
+   MU_RUN_TEST(test_status_code_works_with_io_error);
+   MU_RUN_TEST(test_status_string_works_with_io_error);
+   MU_RUN_TEST(test_status_code_works_with_invalid_argument_error);
+   MU_RUN_TEST(test_status_string_works_with_invalid_argument_error);
 }
 
 int 
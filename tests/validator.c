@@ -0,0 +1,163 @@
+/*
+ * labpack - A LabVIEW-Friendly C library for encoding and decoding MessagePack
+ * data
+ *
+ * Copyright (c) 2017 Field R&D Services, LLC. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * withoutmodification, are permitted provided that the following conditions
+ * are met: 
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution. 
+ * 3. Neither the name of the Field R&D Services nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY Field R&D Services, LLC ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Field R&D Services, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Contributor(s):
+ *   Christopher R. Field <chris@fieldrndservices.com>
+ */
+
+
+#include "minunit.h"
+#include "labpack.h"
+#include "private.h"
+
+static const char* UNEXPECTED_STATUS = "The status is not the expected status";
+static const char* UNEXPECTED_OFFSET = "The error offset is not the expected offset";
+
+MU_TEST(test_validate_works)
+{
+    size_t offset = 1;
+    labpack_status_t status = labpack_validate(MSGPACK_HOME_PAGE_EXAMPLE_OUTPUT, MSGPACK_HOME_PAGE_EXAMPLE_LENGTH, 1, &offset);
+    mu_assert(status == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(offset == 0, UNEXPECTED_OFFSET);
+}
+
+MU_TEST(test_validate_works_with_scalar)
+{
+    mu_assert(labpack_validate("\xcb\x40\x09\x21\xf9\xf0\x1b\x86\x6e", 9, 0, NULL) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_validate_works_with_nested_containers)
+{
+    // [[1, {"a": [true]}], "bc", bin(2), ext(1, 1)]
+    const char data[] = "\x94\x92\x01\x81\xa1\x61\x91\xc3\xa2\x62\x63\xc4\x02\x00\x01\xd4\x01\x00";
+    mu_assert(labpack_validate(data, sizeof(data) - 1, 4, NULL) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_validate_works_with_empty_containers)
+{
+    mu_assert(labpack_validate("\x92\x90\x80", 3, 2, NULL) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_validate_errors_with_null_data)
+{
+    mu_assert(labpack_validate(NULL, 1, 1, NULL) == LABPACK_STATUS_ERROR_NULL_VALUE, UNEXPECTED_STATUS);
+}
+
+MU_TEST(test_validate_errors_with_empty_data)
+{
+    size_t offset = 1;
+    mu_assert(labpack_validate(NULL, 0, 1, &offset) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(offset == 0, UNEXPECTED_OFFSET);
+}
+
+MU_TEST(test_validate_errors_with_invalid_type)
+{
+    size_t offset = 0;
+    mu_assert(labpack_validate("\x92\x01\xc1", 3, 1, &offset) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(offset == 2, UNEXPECTED_OFFSET);
+}
+
+MU_TEST(test_validate_errors_with_truncated_value)
+{
+    size_t offset = 0;
+    mu_assert(labpack_validate("\x91\xcd\x01", 3, 1, &offset) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(offset == 1, UNEXPECTED_OFFSET);
+}
+
+MU_TEST(test_validate_errors_with_truncated_string)
+{
+    size_t offset = 0;
+    mu_assert(labpack_validate("\xa3\x61\x62", 3, 1, &offset) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(offset == 0, UNEXPECTED_OFFSET);
+}
+
+MU_TEST(test_validate_errors_with_missing_elements)
+{
+    size_t offset = 0;
+    mu_assert(labpack_validate("\x93\x01\x02", 3, 1, &offset) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(offset == 0, UNEXPECTED_OFFSET);
+}
+
+MU_TEST(test_validate_errors_with_huge_count)
+{
+    size_t offset = 0;
+    mu_assert(labpack_validate("\xdd\xff\xff\xff\xff\x01", 6, 1, &offset) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(offset == 0, UNEXPECTED_OFFSET);
+}
+
+MU_TEST(test_validate_errors_with_trailing_data)
+{
+    size_t offset = 0;
+    mu_assert(labpack_validate("\x91\x01\x02", 3, 1, &offset) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(offset == 2, UNEXPECTED_OFFSET);
+}
+
+MU_TEST(test_validate_errors_with_too_deep_nesting)
+{
+    size_t offset = 0;
+    mu_assert(labpack_validate("\x91\x91\x91\xc0", 4, 3, NULL) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+    mu_assert(labpack_validate("\x91\x91\x91\xc0", 4, 2, &offset) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(offset == 2, UNEXPECTED_OFFSET);
+}
+
+MU_TEST(test_validate_limits_max_depth)
+{
+    char data[LABPACK_MAX_DEPTH + 2];
+    memset(data, 0x91, LABPACK_MAX_DEPTH + 1);
+    data[LABPACK_MAX_DEPTH + 1] = 0x01;
+    mu_assert(labpack_validate(data, LABPACK_MAX_DEPTH + 2, UINT32_MAX, NULL) == LABPACK_STATUS_ERROR_DECODER, UNEXPECTED_STATUS);
+    mu_assert(labpack_validate(data + 1, LABPACK_MAX_DEPTH + 1, UINT32_MAX, NULL) == LABPACK_STATUS_OK, UNEXPECTED_STATUS);
+}
+
+MU_TEST_SUITE(validate)
+{
+    MU_RUN_TEST(test_validate_works);
+    MU_RUN_TEST(test_validate_works_with_scalar);
+    MU_RUN_TEST(test_validate_works_with_nested_containers);
+    MU_RUN_TEST(test_validate_works_with_empty_containers);
+    MU_RUN_TEST(test_validate_errors_with_null_data);
+    MU_RUN_TEST(test_validate_errors_with_empty_data);
+    MU_RUN_TEST(test_validate_errors_with_invalid_type);
+    MU_RUN_TEST(test_validate_errors_with_truncated_value);
+    MU_RUN_TEST(test_validate_errors_with_truncated_string);
+    MU_RUN_TEST(test_validate_errors_with_missing_elements);
+    MU_RUN_TEST(test_validate_errors_with_huge_count);
+    MU_RUN_TEST(test_validate_errors_with_trailing_data);
+    MU_RUN_TEST(test_validate_errors_with_too_deep_nesting);
+    MU_RUN_TEST(test_validate_limits_max_depth);
+}
+
+int 
+main(int argc, char* argv[]) 
+{
+    MU_RUN_SUITE(validate);
+    MU_REPORT();
+    return minunit_fail;
+}
@@ -32,6 +32,9 @@
  *   Christopher R. Field <chris@fieldrndservices.com>
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "minunit.h"
 #include "labpack.h"
 #include "private.h"
@@ -99,6 +102,22 @@ MU_TEST(test_writer_end_works)
     mu_assert(labpack_writer_is_ok(writer), "Failed to end writer");
 }
 
+MU_TEST(test_writer_end_errors_with_unfinished_map)
+{
+    labpack_writer_begin(writer);
+    labpack_writer_begin_map(writer, 0);
+    labpack_writer_end(writer);
+    mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_ERROR_ENCODER, "Writer status is not an encoder error");
+}
+
+MU_TEST(test_writer_end_array_errors_without_begin)
+{
+    labpack_writer_begin(writer);
+    labpack_writer_end_array(writer);
+    mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_ERROR_ENCODER, "Writer status is not an encoder error");
+    labpack_writer_end(writer);
+}
+
 MU_TEST(test_writer_status_works)
 {
     mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_OK, "Writer status is not OK");
@@ -468,6 +487,174 @@ MU_TEST(test_end_type_works)
     mu_assert(labpack_writer_is_ok(writer), "Failed to end type"); 
 }
 
+#define BOOLS_COUNT 10000
+
+static char*
+end_and_copy(size_t* size)
+{
+    labpack_writer_end(writer);
+    *size = labpack_writer_buffer_size(writer);
+    char* buffer = malloc(*size);
+    labpack_writer_buffer_data(writer, buffer);
+    return buffer;
+}
+
+MU_TEST(test_write_bool_array_works)
+{
+    static bool values[BOOLS_COUNT];
+    for (uint32_t i = 0; i < BOOLS_COUNT; i++) {
+        values[i] = i % 3 == 0 || i % 7 == 0;
+    }
+    labpack_writer_begin(writer);
+    labpack_write_bool_array(writer, values, BOOLS_COUNT);
+    size_t size = 0;
+    char* buffer = end_and_copy(&size);
+    mu_assert(labpack_writer_is_ok(writer), "Failed to write bool array");
+    mu_assert(size == 3 + BOOLS_COUNT, "Actual value does not match expected value");
+    mu_assert(!memcmp(buffer, "\xdc\x27\x10", 3), "Actual value does not match expected value");
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < BOOLS_COUNT; i++) {
+        mismatches += (uint8_t)buffer[3 + i] != (values[i] ? 0xc3 : 0xc2);
+    }
+    free(buffer);
+    mu_assert(mismatches == 0, "Actual value does not match expected value");
+}
+
+MU_TEST(test_write_bool_array_works_with_empty_array)
+{
+    labpack_writer_begin(writer);
+    labpack_write_bool_array(writer, NULL, 0);
+    size_t size = 0;
+    char* buffer = end_and_copy(&size);
+    mu_assert(labpack_writer_is_ok(writer), "Failed to write bool array");
+    mu_assert(size == 1 && (uint8_t)buffer[0] == 0x90, "Actual value does not match expected value");
+    free(buffer);
+}
+
+MU_TEST(test_write_bool_array_errors_with_null_values)
+{
+    labpack_writer_begin(writer);
+    labpack_write_bool_array(writer, NULL, 1);
+    mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_ERROR_NULL_VALUE, "Error status is not correct");
+    labpack_writer_end(writer);
+}
+
+MU_TEST(test_write_bool_bitset_works)
+{
+    static uint8_t bits[(BOOLS_COUNT + 7) / 8];
+    for (uint32_t i = 0; i < sizeof(bits); i++) {
+        bits[i] = (uint8_t)(i * 37 + 11);
+    }
+    labpack_writer_begin(writer);
+    labpack_write_u8(writer, 1);
+    labpack_write_bool_bitset(writer, bits, BOOLS_COUNT - 3);
+    size_t size = 0;
+    char* buffer = end_and_copy(&size);
+    mu_assert(labpack_writer_is_ok(writer), "Failed to write bool bitset");
+    mu_assert(size == 4 + BOOLS_COUNT - 3, "Actual value does not match expected value");
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < BOOLS_COUNT - 3; i++) {
+        bool expected = (bits[i / 8] >> (i % 8)) & 1;
+        mismatches += (uint8_t)buffer[4 + i] != (expected ? 0xc3 : 0xc2);
+    }
+    free(buffer);
+    mu_assert(mismatches == 0, "Actual value does not match expected value");
+}
+
+MU_TEST(test_write_bool_bitset_errors_with_null_bits)
+{
+    labpack_writer_begin(writer);
+    labpack_write_bool_bitset(writer, NULL, 1);
+    mu_assert(labpack_writer_status(writer) == LABPACK_STATUS_ERROR_NULL_VALUE, "Error status is not correct");
+    labpack_writer_end(writer);
+}
+
+MU_TEST(test_writer_stats_works)
+{
+    labpack_stats_t stats;
+    labpack_writer_stats(writer, &stats);
+    mu_assert(stats.bytes == 0, "The bytes are not zero");
+    mu_assert(stats.elements == 0, "The elements are not zero");
+    labpack_writer_begin(writer);
+    labpack_writer_begin_map(writer, 2);
+    labpack_write_cstr(writer, "a");
+    labpack_write_u8(writer, 1);
+    labpack_write_cstr(writer, "b");
+    labpack_writer_begin_array(writer, 0);
+    labpack_writer_end_array(writer);
+    labpack_writer_end_map(writer);
+    labpack_writer_end(writer);
+    char buffer[16];
+    labpack_writer_buffer_data(writer, buffer);
+    labpack_writer_stats(writer, &stats);
+    mu_assert(labpack_writer_is_ok(writer), "Failed to end writer");
+    mu_assert(stats.bytes == 7, "The bytes are not correct");
+    mu_assert(stats.elements == 5, "The elements are not correct");
+    mu_assert(stats.containers == 2, "The containers are not correct");
+    mu_assert(stats.allocations == 1, "The allocations are not correct");
+    mu_assert(stats.reallocations == 0, "The reallocations are not correct");
+    mu_assert(stats.bytes_copied == 7, "The bytes copied are not correct");
+    mu_assert(stats.errors == 0, "The errors are not correct");
+}
+
+MU_TEST(test_writer_stats_works_with_bool_array)
+{
+    const bool values[3] = { true, false, true };
+    labpack_stats_t stats;
+    labpack_writer_begin(writer);
+    labpack_write_bool_array(writer, values, 3);
+    labpack_writer_end(writer);
+    labpack_writer_stats(writer, &stats);
+    mu_assert(stats.elements == 4, "The elements are not correct");
+    mu_assert(stats.containers == 1, "The containers are not correct");
+}
+
+MU_TEST(test_writer_stats_reuses_buffer_between_messages)
+{
+    char* data = malloc(10000);
+    memset(data, 'a', 10000);
+    labpack_stats_t stats;
+    for (int i = 0; i < 100; i++) {
+        labpack_writer_begin(writer);
+        labpack_write_u32(writer, i);
+        labpack_writer_end(writer);
+    }
+    labpack_writer_stats(writer, &stats);
+    mu_assert(stats.allocations == 1, "The buffer was allocated for each message");
+    mu_assert(stats.reallocations == 0, "The buffer was reallocated for small messages");
+    labpack_writer_begin(writer);
+    labpack_write_str(writer, data, 10000);
+    labpack_writer_end(writer);
+    labpack_writer_stats(writer, &stats);
+    uint64_t reallocations = stats.reallocations;
+    mu_assert(reallocations > 0, "The buffer was not grown for a large message");
+    labpack_writer_begin(writer);
+    labpack_write_str(writer, data, 10000);
+    labpack_writer_end(writer);
+    labpack_writer_stats(writer, &stats);
+    mu_assert(stats.reallocations == reallocations, "The buffer was grown again for the same size of message");
+    mu_assert(labpack_writer_buffer_size(writer) == 10003, "The buffer size is not correct");
+    free(data);
+}
+
+MU_TEST(test_writer_stats_counts_errors)
+{
+    labpack_stats_t stats;
+    labpack_writer_begin(writer);
+    labpack_write_cstr(writer, NULL);
+    labpack_writer_end(writer);
+    labpack_writer_stats(writer, &stats);
+    mu_assert(stats.errors == 1, "The error was not counted");
+    labpack_writer_begin(writer);
+    labpack_writer_stats(writer, &stats);
+    mu_assert(stats.errors == 1, "The cleared error was counted again");
+    labpack_writer_end_map(writer);
+    labpack_writer_end(writer);
+    labpack_writer_stats(writer, &stats);
+    mu_assert(stats.errors == 2, "The second error was not counted");
+    mu_assert(stats.bytes == 0, "The bytes of a message with an error were counted");
+}
+
 MU_TEST_SUITE(writer_create_and_destroy) 
 {
     MU_RUN_TEST(test_writer_sanity_check);
@@ -483,6 +670,8 @@ MU_TEST_SUITE(writer_begin_and_end)
 
     MU_RUN_TEST(test_writer_begin_works);
     MU_RUN_TEST(test_writer_end_works);
+    MU_RUN_TEST(test_writer_end_errors_with_unfinished_map);
+    MU_RUN_TEST(test_writer_end_array_errors_without_begin);
 }
 
 MU_TEST_SUITE(writer_buffer)
@@ -575,6 +764,27 @@ MU_TEST_SUITE(chunked_data)
     MU_RUN_TEST(test_end_type_works);
 }
 
+MU_TEST_SUITE(bool_arrays)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_write_bool_array_works);
+    MU_RUN_TEST(test_write_bool_array_works_with_empty_array);
+    MU_RUN_TEST(test_write_bool_array_errors_with_null_values);
+    MU_RUN_TEST(test_write_bool_bitset_works);
+    MU_RUN_TEST(test_write_bool_bitset_errors_with_null_bits);
+}
+
+MU_TEST_SUITE(writer_stats)
+{
+    MU_SUITE_CONFIGURE((void*)&setup, (void*)&teardown);
+
+    MU_RUN_TEST(test_writer_stats_works);
+    MU_RUN_TEST(test_writer_stats_works_with_bool_array);
+    MU_RUN_TEST(test_writer_stats_reuses_buffer_between_messages);
+    MU_RUN_TEST(test_writer_stats_counts_errors);
+}
+
 int 
 main(int argc, char* argv[]) 
 {
@@ -586,6 +796,8 @@ main(int argc, char* argv[])
     MU_RUN_SUITE(arrays_and_maps);
     MU_RUN_SUITE(data_helpers);
     MU_RUN_SUITE(chunked_data);
+    MU_RUN_SUITE(bool_arrays);
+    MU_RUN_SUITE(writer_stats);
 	MU_REPORT();
 	return minunit_fail;
 }